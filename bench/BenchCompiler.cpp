@@ -0,0 +1,126 @@
+#include "programs.hpp"
+#include "pljit/lexer/lexer.hpp"
+#include "pljit/optimization/pass_manager.hpp"
+#include "pljit/optimization/passes/UnaryPlusRemoval.hpp"
+#include "pljit/optimization/passes/algebraic_simplification.hpp"
+#include "pljit/optimization/passes/constant_propagation.hpp"
+#include "pljit/optimization/passes/dead_code_elimination.hpp"
+#include "pljit/optimization/passes/dead_store_elimination.hpp"
+#include "pljit/optimization/passes/ssa_optimization.hpp"
+#include "pljit/optimization/passes/reassociation.hpp"
+#include "pljit/parser/parse_tree_nodes.hpp"
+#include "pljit/parser/parser.hpp"
+#include "pljit/semantic_analysis/AST.hpp"
+#include "pljit/semantic_analysis/ASTCreator.hpp"
+#include <benchmark/benchmark.h>
+#include <chrono>
+
+using namespace pljit;
+
+namespace {
+
+void set_processed(benchmark::State& state, const std::string& program) {
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * program.size()));
+    state.counters["statements"] = static_cast<double>(state.range(0));
+}
+
+std::unique_ptr<semantic_analysis::FunctionNode> analyze(const source_management::SourceCode& code) {
+    lexer::lexer lexer(code);
+    parser::parser parser(lexer);
+    auto parse_tree = parser.parse_function_definition();
+    return semantic_analysis::ASTCreator::CreateAST(*parse_tree);
+}
+
+void BM_SourceCode(benchmark::State& state) {
+    const auto program = bench::make_program(static_cast<unsigned>(state.range(0)));
+    for (auto _ : state) {
+        source_management::SourceCode code(program);
+        benchmark::DoNotOptimize(code);
+    }
+    set_processed(state, program);
+}
+BENCHMARK(BM_SourceCode)->RangeMultiplier(8)->Range(bench::min_statements, bench::max_statements);
+
+void BM_Lexer(benchmark::State& state) {
+    const source_management::SourceCode code(bench::make_program(static_cast<unsigned>(state.range(0))));
+    int64_t tokens = 0;
+    for (auto _ : state) {
+        lexer::lexer lexer(code);
+        // The lexer keeps returning EOS at the end of the input
+        for (auto token = lexer.next(); token && token->Type() != lexer::TokenType::EOS; token = lexer.next()) {
+            benchmark::DoNotOptimize(token);
+            ++tokens;
+        }
+    }
+    state.SetItemsProcessed(tokens);
+    set_processed(state, std::string(code.begin(), code.end()));
+}
+BENCHMARK(BM_Lexer)->RangeMultiplier(8)->Range(bench::min_statements, bench::max_statements);
+
+void BM_Parser(benchmark::State& state) {
+    const auto program = bench::make_program(static_cast<unsigned>(state.range(0)));
+    const source_management::SourceCode code(program);
+    for (auto _ : state) {
+        lexer::lexer lexer(code);
+        parser::parser parser(lexer);
+        auto parse_tree = parser.parse_function_definition();
+        if (!parse_tree) state.SkipWithError("Invalid program");
+        benchmark::DoNotOptimize(parse_tree);
+    }
+    set_processed(state, program);
+}
+BENCHMARK(BM_Parser)->RangeMultiplier(8)->Range(bench::min_statements, bench::max_statements);
+
+void BM_ASTCreator(benchmark::State& state) {
+    const auto program = bench::make_program(static_cast<unsigned>(state.range(0)));
+    const source_management::SourceCode code(program);
+    lexer::lexer lexer(code);
+    parser::parser parser(lexer);
+    const auto parse_tree = parser.parse_function_definition();
+    for (auto _ : state) {
+        auto ast = semantic_analysis::ASTCreator::CreateAST(*parse_tree);
+        if (!ast) state.SkipWithError("Invalid program");
+        benchmark::DoNotOptimize(ast);
+    }
+    set_processed(state, program);
+}
+BENCHMARK(BM_ASTCreator)->RangeMultiplier(8)->Range(bench::min_statements, bench::max_statements);
+
+/// Passes modify the AST, so every iteration analyzes a fresh one. Only the pass itself is timed.
+template <class Pass>
+void BM_Pass(benchmark::State& state) {
+    const auto program = bench::make_program(static_cast<unsigned>(state.range(0)));
+    const source_management::SourceCode code(program);
+    for (auto _ : state) {
+        auto ast = analyze(code);
+        const auto start = std::chrono::steady_clock::now();
+        Pass().optimize_ast(ast);
+        benchmark::DoNotOptimize(ast);
+        state.SetIterationTime(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+    }
+    set_processed(state, program);
+}
+BENCHMARK_TEMPLATE(BM_Pass, optimization::passes::UnaryPlusRemoval)->RangeMultiplier(8)->Range(bench::min_statements, bench::max_statements)->UseManualTime();
+BENCHMARK_TEMPLATE(BM_Pass, optimization::passes::constant_propagation)->RangeMultiplier(8)->Range(bench::min_statements, bench::max_statements)->UseManualTime();
+BENCHMARK_TEMPLATE(BM_Pass, optimization::passes::algebraic_simplification)->RangeMultiplier(8)->Range(bench::min_statements, bench::max_statements)->UseManualTime();
+BENCHMARK_TEMPLATE(BM_Pass, optimization::passes::dead_code_elimination)->RangeMultiplier(8)->Range(bench::min_statements, bench::max_statements)->UseManualTime();
+BENCHMARK_TEMPLATE(BM_Pass, optimization::passes::dead_store_elimination)->RangeMultiplier(8)->Range(bench::min_statements, bench::max_statements)->UseManualTime();
+BENCHMARK_TEMPLATE(BM_Pass, optimization::passes::ssa_optimization)->RangeMultiplier(8)->Range(bench::min_statements, bench::max_statements)->UseManualTime();
+BENCHMARK_TEMPLATE(BM_Pass, optimization::passes::reassociation)->RangeMultiplier(8)->Range(bench::min_statements, bench::max_statements)->UseManualTime();
+
+void BM_PassPipeline(benchmark::State& state, optimization::optimization_level level) {
+    const auto program = bench::make_program(static_cast<unsigned>(state.range(0)));
+    const source_management::SourceCode code(program);
+    for (auto _ : state) {
+        auto ast = analyze(code);
+        const auto start = std::chrono::steady_clock::now();
+        optimization::pass_manager(level).run(ast);
+        benchmark::DoNotOptimize(ast);
+        state.SetIterationTime(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+    }
+    set_processed(state, program);
+}
+BENCHMARK_CAPTURE(BM_PassPipeline, O1, optimization::optimization_level::O1)->RangeMultiplier(8)->Range(bench::min_statements, bench::max_statements)->UseManualTime();
+BENCHMARK_CAPTURE(BM_PassPipeline, O2, optimization::optimization_level::O2)->RangeMultiplier(8)->Range(bench::min_statements, bench::max_statements)->UseManualTime();
+
+} // namespace
@@ -0,0 +1,64 @@
+#include "programs.hpp"
+#include "pljit/Pljit.hpp"
+#include <benchmark/benchmark.h>
+
+using namespace pljit;
+
+namespace {
+
+constexpr int64_t a = 5;
+constexpr int64_t b = 3;
+
+/// Per call overhead of Function::operator() on an already compiled function
+void BM_Call(benchmark::State& state, execution_engine engine) {
+    const auto statements = static_cast<unsigned>(state.range(0));
+    Function function(bench::make_program(statements), function_options(engine));
+    const auto expected = bench::baseline(statements, a, b);
+    if (!function.wait() || function(a, b).get_result() != expected) {
+        state.SkipWithError("Wrong result");
+        return;
+    }
+    for (auto _ : state) {
+        auto result = function(a, b);
+        benchmark::DoNotOptimize(result);
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.counters["statements"] = static_cast<double>(statements);
+}
+BENCHMARK_CAPTURE(BM_Call, interpreter, execution_engine::INTERPRETER)->RangeMultiplier(8)->Range(bench::min_statements, bench::max_statements);
+BENCHMARK_CAPTURE(BM_Call, native, execution_engine::NATIVE)->RangeMultiplier(8)->Range(bench::min_statements, bench::max_statements);
+BENCHMARK_CAPTURE(BM_Call, bytecode, execution_engine::BYTECODE)->RangeMultiplier(8)->Range(bench::min_statements, bench::max_statements);
+BENCHMARK_CAPTURE(BM_Call, closure, execution_engine::CLOSURE)->RangeMultiplier(8)->Range(bench::min_statements, bench::max_statements);
+BENCHMARK_CAPTURE(BM_Call, copy_and_patch, execution_engine::COPY_AND_PATCH)->RangeMultiplier(8)->Range(bench::min_statements, bench::max_statements);
+
+/// BM_Call with runtime statistics, run with several threads to expose contention on the counters
+void BM_CallMeasured(benchmark::State& state) {
+    function_options options(execution_engine::NATIVE);
+    options.collect_runtime_statistics = true;
+    static Function function(bench::make_program(8), options);
+    for (auto _ : state) {
+        auto result = function(a, b);
+        benchmark::DoNotOptimize(result);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_CallMeasured)->ThreadRange(1, 8)->UseRealTime();
+
+/// The same computation written in C++, the lower bound for BM_Call
+void BM_Baseline(benchmark::State& state) {
+    const auto statements = static_cast<unsigned>(state.range(0));
+    int64_t parameter_a = a;
+    int64_t parameter_b = b;
+    for (auto _ : state) {
+        // Hides the constant arguments from the optimizer
+        benchmark::DoNotOptimize(parameter_a);
+        benchmark::DoNotOptimize(parameter_b);
+        auto result = bench::baseline(statements, parameter_a, parameter_b);
+        benchmark::DoNotOptimize(result);
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.counters["statements"] = static_cast<double>(statements);
+}
+BENCHMARK(BM_Baseline)->RangeMultiplier(8)->Range(bench::min_statements, bench::max_statements);
+
+} // namespace
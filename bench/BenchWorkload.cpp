@@ -0,0 +1,47 @@
+#include "programs.hpp"
+#include "pljit/Pljit.hpp"
+#include "pljit/workload/program_generator.hpp"
+#include <benchmark/benchmark.h>
+
+using namespace pljit;
+
+namespace {
+
+workload::generator_options workload_options(int64_t statements) {
+    workload::generator_options options;
+    options.parameters = 8;
+    options.variables = 32;
+    options.constants = 8;
+    options.statements = static_cast<unsigned>(statements);
+    options.argument_sets = 1;
+    return options;
+}
+
+/// Whole compilation of one random program, from the source to executable code
+void BM_Compile(benchmark::State& state, execution_engine engine) {
+    const auto program = workload::program_generator(workload_options(state.range(0))).generate();
+    for (auto _ : state) {
+        Function function(program.source, engine);
+        if (!function.wait()) state.SkipWithError("Invalid program");
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * program.source.size()));
+    state.counters["statements"] = static_cast<double>(state.range(0));
+}
+BENCHMARK_CAPTURE(BM_Compile, native, execution_engine::NATIVE)->RangeMultiplier(8)->Range(bench::min_statements, bench::max_statements);
+BENCHMARK_CAPTURE(BM_Compile, bytecode, execution_engine::BYTECODE)->RangeMultiplier(8)->Range(bench::min_statements, bench::max_statements);
+
+/// Registers range(0) distinct random programs of 32 statements at once
+void BM_RegisterFunctions(benchmark::State& state) {
+    workload::program_generator generator(workload_options(32));
+    std::vector<std::string> sources;
+    for (int64_t i = 0; i < state.range(0); ++i) sources.push_back(generator.generate().source);
+    for (auto _ : state) {
+        Pljit compiler;
+        auto results = compiler.register_functions(sources);
+        benchmark::DoNotOptimize(results);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_RegisterFunctions)->RangeMultiplier(8)->Range(64, 4096)->UseRealTime();
+
+} // namespace
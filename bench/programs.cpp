@@ -0,0 +1,52 @@
+#include "programs.hpp"
+
+namespace pljit::bench {
+
+namespace {
+/// Identifiers may only contain letters
+std::string variable_name(unsigned index) {
+    std::string name = "v";
+    do {
+        name.push_back(static_cast<char>('a' + index % 26));
+        index /= 26;
+    } while (index);
+    return name;
+}
+} // namespace
+
+std::string make_program(unsigned statements) {
+    std::string program = "PARAM a, b;\nVAR ";
+    for (unsigned i = 0; i < statements; ++i) {
+        if (i) program += ", ";
+        program += variable_name(i);
+    }
+    program += ";\nCONST k = 3, m = 2;\nBEGIN\n";
+    program += variable_name(0) + " := a + k * m";
+    for (unsigned i = 1; i < statements; ++i) {
+        const auto previous = variable_name(i - 1);
+        program += ";\n" + variable_name(i) + " := ";
+        switch (i % 3) {
+            case 0: program += previous + " + a - b"; break;
+            case 1: program += "(" + previous + " * m + b) / m"; break;
+            default: program += previous + " - (k - m) * a"; break;
+        }
+    }
+    program += ";\nRETURN " + variable_name(statements - 1) + "\nEND.\n";
+    return program;
+}
+
+int64_t baseline(unsigned statements, int64_t a, int64_t b) {
+    const int64_t k = 3, m = 2;
+    int64_t value = a + k * m;
+    for (unsigned i = 1; i < statements; ++i) {
+        switch (i % 3) {
+            // The parser is right associative
+            case 0: value = value + (a - b); break;
+            case 1: value = (value * m + b) / m; break;
+            default: value = value - (k - m) * a; break;
+        }
+    }
+    return value;
+}
+
+} // namespace pljit::bench
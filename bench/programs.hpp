@@ -0,0 +1,24 @@
+#ifndef PLJIT_BENCH_PROGRAMS_HPP
+#define PLJIT_BENCH_PROGRAMS_HPP
+
+#include <cstdint>
+#include <string>
+
+namespace pljit::bench {
+
+/// Smallest and largest program size of the size parameterized benchmarks, in statements
+constexpr int64_t min_statements = 8;
+constexpr int64_t max_statements = 4096;
+
+/**
+ * Valid PL function with two parameters and one variable per statement. Every statement depends on its
+ * predecessor, so optimizations cannot drop any of them.
+ */
+std::string make_program(unsigned statements);
+
+/// Hand-written C++ equivalent of make_program(statements)
+int64_t baseline(unsigned statements, int64_t a, int64_t b);
+
+} // namespace pljit::bench
+
+#endif //PLJIT_BENCH_PROGRAMS_HPP
@@ -1,37 +1,238 @@
 
 #include "Pljit.hpp"
+#include "pljit/codegen/bytecode/bytecode_generator.hpp"
+#include "pljit/codegen/closure/closure_compiler.hpp"
+#include "pljit/codegen/copy_and_patch/stencil_compiler.hpp"
+#include "pljit/codegen/x86_64/code_generator.hpp"
 #include "pljit/execution/ExecutionContext.hpp"
+#include "pljit/execution/ast_interpreter.hpp"
+#include "pljit/execution/atomic_wait.hpp"
+#include "pljit/execution/batch_evaluator.hpp"
 #include "pljit/lexer/lexer.hpp"
+#include "pljit/optimization/pass_manager.hpp"
 #include "pljit/parser/parser.hpp"
+#include "pljit/persistence/snapshot_image.hpp"
 #include "pljit/semantic_analysis/AST.hpp"
 #include "pljit/semantic_analysis/ASTCreator.hpp"
+#include "pljit/source_management/diagnostics.hpp"
+#include <algorithm>
+#include <sstream>
 
 namespace pljit {
 
-execution::ExecutionContext Function::call_impl(std::initializer_list<int64_t> parameters) {
-    execution::ExecutionContext context(ast->getSymbolTable(), parameters);
-    ast->evaluate(context);
-    return context;
+namespace {
+/// @return The compiled function or nullptr if the AST has to be interpreted
+std::unique_ptr<execution::compiled_function> generate_code(execution_engine engine, semantic_analysis::FunctionNode& ast) {
+    switch (engine) {
+        case execution_engine::INTERPRETER: return nullptr;
+        case execution_engine::NATIVE: {
+            // Falls back to interpreting the AST if no code can be generated
+            return codegen::x86_64::code_generator::compile(ast);
+        }
+        case execution_engine::BYTECODE: return codegen::bytecode::bytecode_generator::compile(ast);
+        case execution_engine::CLOSURE: return codegen::closure::closure_compiler::compile(ast);
+        case execution_engine::COPY_AND_PATCH: return codegen::copy_and_patch::stencil_compiler::compile(ast);
+    }
+    return nullptr;
 }
+} // namespace
 
-void Function::compile() {
-    std::unique_lock compile_lock{compilation_mutex};
-    if (ast) return;
-#ifndef NDEBUG
-    compilation_passed++;
-#endif
+std::optional<int64_t> Function::call(const int64_t* parameters, int64_t* frame, pending_compilation policy) {
+    return call_checked(parameters, unchecked_arity, frame, policy);
+}
+
+std::optional<int64_t> Function::call_checked(const int64_t* parameters, std::size_t number_of_arguments, int64_t* frame, pending_compilation policy) {
+    if (!call_statistics) return call_unmeasured(parameters, number_of_arguments, frame, policy);
+    const auto start = std::chrono::steady_clock::now();
+    auto result = call_unmeasured(parameters, number_of_arguments, frame, policy);
+    call_statistics->record(std::chrono::steady_clock::now() - start, result.has_value());
+    return result;
+}
+
+std::optional<int64_t> Function::call_unmeasured(const int64_t* parameters, std::size_t number_of_arguments, int64_t* frame, pending_compilation policy) {
+    if (policy != pending_compilation::WAIT) {
+        const auto current = static_cast<compilation_state>(state.load(std::memory_order_acquire));
+        // Without background compilation, nobody else compiles an uncompiled function
+        const bool in_flight = current == compilation_state::COMPILING || (current == compilation_state::UNCOMPILED && options.background_compilation);
+        if (in_flight) {
+            if (policy == pending_compilation::FAIL) return std::nullopt;
+            return interpret_uncompiled(parameters, number_of_arguments);
+        }
+    }
+    if (!ensure_compiled()) return std::nullopt;
+    if (number_of_arguments != unchecked_arity && number_of_arguments != get_number_of_parameters()) return std::nullopt;
+    if (frame) return call_impl(parameters, frame);
+
+    if (frame_template.size() <= execution::compiled_function::inline_frame_size) {
+        int64_t inline_frame[execution::compiled_function::inline_frame_size];
+        return call_impl(parameters, inline_frame);
+    }
+    thread_local std::vector<int64_t> large_frame;
+    if (large_frame.size() < frame_template.size()) large_frame.resize(frame_template.size());
+    return call_impl(parameters, large_frame.data());
+}
+
+std::optional<int64_t> Function::call_impl(const int64_t* parameters, int64_t* frame) {
+    if (const auto* code = optimized_code.load(std::memory_order_acquire)) {
+        // The caller's frame is only sized for the tier that was active when it asked for the frame size
+        if (code->get_frame_size() > frame_template.size()) return code->execute(parameters);
+        return code->execute(parameters, frame);
+    }
+    if (compiled_code) {
+        return compiled_code->execute(parameters, frame);
+    }
+    if (options.tier_up_threshold > 0 && call_count.fetch_add(1, std::memory_order_relaxed) + 1 == options.tier_up_threshold) {
+        // Exactly one caller crosses the threshold and starts the tier-up
+        auto expected = static_cast<uint32_t>(compilation_state::READY);
+        if (state.compare_exchange_strong(expected, static_cast<uint32_t>(compilation_state::OPTIMIZING), std::memory_order_relaxed)) {
+            if (tier_up_workers) {
+                tier_up_workers->submit([this] { tier_up(); });
+            } else {
+                tier_up();
+            }
+        }
+    }
+    return execution::ast_interpreter::evaluate(*ast, frame_template, parameters, frame);
+}
+
+std::optional<int64_t> Function::interpret_uncompiled(const int64_t* parameters, std::size_t number_of_arguments) const {
+    auto private_ast = analyze();
+    if (!private_ast) return std::nullopt;
+    if (number_of_arguments != unchecked_arity && number_of_arguments != private_ast->getSymbolTable().get_number_of_parameters()) return std::nullopt;
+    const auto private_frame_template = execution::ast_interpreter::create_frame_template(private_ast->getSymbolTable());
+    std::vector<int64_t> private_frame(private_frame_template.size());
+    return execution::ast_interpreter::evaluate(*private_ast, private_frame_template, parameters, private_frame.data());
+}
+
+std::size_t Function::get_frame_size() {
+    if (!ensure_compiled()) return 0;
+    return frame_template.size();
+}
+
+std::size_t Function::get_number_of_parameters() const {
+    return ast->getSymbolTable().get_number_of_parameters();
+}
+
+std::unique_ptr<semantic_analysis::FunctionNode> Function::analyze(compile_statistics* statistics) const {
+    phase_timer timer(statistics);
     pljit::lexer::lexer lexer(source_code);
     pljit::parser::parser parser(lexer);
     auto parse_tree = parser.parse_function_definition();
+    timer.end_phase(compile_statistics::PARSE);
+    if (statistics) {
+        statistics->bytes_lexed += source_code.get_offset(lexer.get_current_position());
+        if (parse_tree) statistics->count(*parse_tree);
+    }
+
+    if (!parse_tree) return nullptr;
+
+    timer.restart();
+    auto ast = pljit::semantic_analysis::ASTCreator::CreateAST(*parse_tree);
+    timer.end_phase(compile_statistics::SEMANTIC_ANALYSIS);
+    if (statistics && ast) statistics->count(*ast);
+    return ast;
+}
 
-    if (!parse_tree) {
-        compilation_failed = true;
+void Function::tier_up() {
+    // The interpreted AST is in use by concurrent callers, optimize a fresh copy
+    auto optimized_ast = analyze();
+    if (!optimized_ast) {
+        state.store(static_cast<uint32_t>(compilation_state::OPTIMIZED), std::memory_order_release);
         return;
     }
 
-    ast = pljit::semantic_analysis::ASTCreator::CreateAST(*parse_tree);
+    optimization::pass_manager passes(options.optimization);
+    passes.run(optimized_ast);
+    // Published together with the optimized code
+    pass_statistics = passes.get_statistics();
+
+    optimized_code_storage = generate_code(options.engine, *optimized_ast);
+    if (!optimized_code_storage) {
+        optimized_code_storage = std::make_unique<execution::ast_interpreter>(std::move(optimized_ast));
+    }
+    optimized_code.store(optimized_code_storage.get(), std::memory_order_release);
+    state.store(static_cast<uint32_t>(compilation_state::OPTIMIZED), std::memory_order_release);
+}
+
+bool Function::evaluate_batch(const int64_t* const* parameter_columns, std::size_t n, int64_t* out, uint8_t* error_mask) {
+    if (!ensure_compiled()) return false;
+    execution::batch_evaluator evaluator(ast->getSymbolTable());
+    evaluator.evaluate(*ast, parameter_columns, n, out, error_mask);
+    return true;
+}
+
+bool Function::is_optimized() const {
+    return optimized_code.load(std::memory_order_acquire) != nullptr;
+}
+
+bool Function::compile_slow() {
+    auto expected = static_cast<uint32_t>(compilation_state::UNCOMPILED);
+    if (state.compare_exchange_strong(expected, static_cast<uint32_t>(compilation_state::COMPILING), std::memory_order_acquire)) {
+        compile();
+        execution::atomic_notify_all(state);
+        return is_compiled(static_cast<compilation_state>(state.load(std::memory_order_relaxed)));
+    }
+    // Another thread compiles the function
+    while (expected == static_cast<uint32_t>(compilation_state::COMPILING)) {
+        execution::atomic_wait(state, expected);
+        expected = state.load(std::memory_order_acquire);
+    }
+    return is_compiled(static_cast<compilation_state>(expected));
+}
+
+void Function::compile() {
+#ifndef NDEBUG
+    compilation_passed++;
+#endif
+    // Without statistics, the timer and every counter are skipped
+    std::unique_ptr<compile_statistics> statistics;
+    if (options.collect_compile_statistics) {
+        statistics = std::make_unique<compile_statistics>();
+        statistics->compilations = 1;
+    }
+    phase_timer timer(statistics.get());
 
-    if (!ast) compilation_failed = true;
+    // A cached AST went through the same passes already
+    const bool cached = disk_cache && (ast = disk_cache->load(disk_cache_key));
+    if (disk_cache) timer.end_phase(compile_statistics::DISK_CACHE);
+    if (cached && statistics) statistics->count(*ast);
+    if (!cached) {
+        std::ostringstream messages;
+        {
+            source_management::diagnostics_redirect redirect(messages);
+            ast = analyze(statistics.get());
+        }
+        diagnostics = messages.str();
+        source_management::diagnostics() << diagnostics;
+    }
+    compilation_statistics = std::move(statistics);
+
+    if (!ast) {
+        state.store(static_cast<uint32_t>(compilation_state::FAILED), std::memory_order_release);
+        return;
+    }
+
+    timer.restart();
+    if (options.tier_up_threshold == 0 && !cached) {
+        optimization::pass_manager passes(options.optimization);
+        passes.run(ast);
+        pass_statistics = passes.get_statistics();
+        timer.end_phase(compile_statistics::OPTIMIZATION);
+        if (compilation_statistics) compilation_statistics->passes = pass_statistics;
+    }
+    if (disk_cache && !cached) {
+        disk_cache->store(disk_cache_key, *ast);
+        timer.end_phase(compile_statistics::DISK_CACHE);
+    }
+    // Passes may add or remove symbols, so the frame follows the optimized symbol table
+    frame_template = execution::ast_interpreter::create_frame_template(ast->getSymbolTable());
+    if (options.tier_up_threshold == 0) {
+        compiled_code = generate_code(options.engine, *ast);
+        // Callers size their frames once, so the frame covers the compiled code as well
+        if (compiled_code) frame_template.resize(std::max(frame_template.size(), compiled_code->get_frame_size()), 0);
+        timer.end_phase(compile_statistics::CODE_GENERATION);
+    }
+    state.store(static_cast<uint32_t>(compilation_state::READY), std::memory_order_release);
 
 #ifndef NDEBUG
     if (compilation_passed > 1) {
@@ -40,15 +241,103 @@ void Function::compile() {
 #endif
 }
 
-Function::Function(std::string source) : source_code(std::move(source)) {
+Function::Function(std::string source, function_options options) : source_code(std::move(source)), options(options) {
+    if (options.collect_runtime_statistics) call_statistics = std::make_unique<runtime_statistics>();
 }
 
 Function::~Function() = default;
 
+bool Pljit::save_image(const std::filesystem::path& path) {
+    std::vector<std::optional<persistence::image_function>> programs;
+    programs.reserve(registered_functions.size());
+    for (uint32_t id = 0; id < registered_functions.size(); ++id) {
+        // Functions still being registered are left out, like failed ones
+        auto* function = registered_functions.try_get(id);
+        if (function && function->wait()) {
+            programs.emplace_back(persistence::snapshot_image::prepare(*function->ast));
+        } else {
+            programs.emplace_back(std::nullopt);
+        }
+    }
+    return persistence::snapshot_image::write(path, persistence::snapshot_image::build(programs));
+}
+
+void Pljit::set_disk_cache(std::filesystem::path directory) {
+    // The key contains the optimization level, the version covers what the passes make of it
+    disk_cache = std::make_unique<persistence::code_cache>(std::move(directory), optimization::pipeline_version);
+}
+
 function_handle Pljit::register_function(std::string source) {
-    // TODO Thread safe
-    registered_functions.emplace_back(std::make_unique<Function>(std::move(source)));
-    return function_handle(this, registered_functions.size() - 1);
+    return register_function(std::move(source), default_options);
+}
+
+function_handle Pljit::register_function(std::string source, function_options options) {
+    // Functions with equal source and options are interchangeable
+    std::string key = compilation_cache::normalize(source);
+    key.push_back('\0');
+    key += std::to_string(static_cast<int>(options.engine)) + ',' + std::to_string(options.tier_up_threshold) + ',' +
+        std::to_string(static_cast<int>(options.optimization)) + ',' + std::to_string(options.background_compilation) + ',' +
+        std::to_string(options.collect_compile_statistics) + ',' + std::to_string(options.collect_runtime_statistics);
+
+    auto [id, function] = compiled_functions.get_or_create(key, [&]() -> compilation_cache::entry {
+        auto function = std::make_unique<Function>(std::move(source), options);
+        if (disk_cache) {
+            function->disk_cache = disk_cache.get();
+            function->disk_cache_key = key;
+        }
+        function->tier_up_workers = &compilation_workers;
+        Function* function_pointer = function.get();
+        const auto id = registered_functions.add(std::move(function));
+        if (options.background_compilation) {
+            compilation_workers.submit([function_pointer] { function_pointer->wait(); });
+        }
+        return {id, function_pointer};
+    });
+    return function_handle(function, id);
+}
+
+compile_statistics Pljit::get_compile_statistics() {
+    compile_statistics total;
+    for (uint32_t id = 0; id < registered_functions.size(); ++id) {
+        const auto* function = registered_functions.try_get(id);
+        if (!function) continue;
+        if (const auto* statistics = function->get_compile_statistics()) total += *statistics;
+    }
+    return total;
+}
+
+statistics_snapshot Pljit::stats_snapshot() {
+    statistics_snapshot snapshot;
+    for (uint32_t id = 0; id < registered_functions.size(); ++id) {
+        const auto* function = registered_functions.try_get(id);
+        if (function && function->call_statistics) snapshot.functions.push_back(function->call_statistics->collect(id));
+    }
+    return snapshot;
+}
+
+std::vector<registration_result> Pljit::register_functions(std::vector<std::string> sources) {
+    return register_functions(std::move(sources), default_options);
+}
+
+std::vector<registration_result> Pljit::register_functions(std::vector<std::string> sources, function_options options) {
+    // Compiled by the loop below under the redirect. A background task would report errors on a worker thread.
+    options.background_compilation = false;
+    std::vector<compilation_cache::entry> entries(sources.size());
+    compilation_workers.parallel_for(sources.size(), [&](std::size_t i) {
+        // Errors are kept in the function, the caller decides what to print
+        source_management::diagnostics_redirect redirect(source_management::null_stream());
+        auto handle = register_function(std::move(sources[i]), options);
+        handle.wait();
+        entries[i] = {handle.function_id, handle.function};
+    });
+
+    std::vector<registration_result> results;
+    results.reserve(entries.size());
+    for (const auto& entry : entries) {
+        const bool success = entry.function->ensure_compiled();
+        results.push_back({function_handle(entry.function, entry.id), success, entry.function->get_diagnostics()});
+    }
+    return results;
 }
 
 } // namespace pljit
\ No newline at end of file
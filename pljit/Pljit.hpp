@@ -2,12 +2,21 @@
 #ifndef PLJIT_PLJIT_HPP
 #define PLJIT_PLJIT_HPP
 
+#include <atomic>
 #include <cstdint>
+#include <limits>
 #include <memory>
-#include <mutex>
 #include <vector>
 
 #include "pljit/execution/ExecutionContext.hpp"
+#include "pljit/execution/compiled_function.hpp"
+#include "pljit/compilation_cache.hpp"
+#include "pljit/compile_statistics.hpp"
+#include "pljit/runtime_statistics.hpp"
+#include "pljit/function_registry.hpp"
+#include "pljit/worker_pool.hpp"
+#include "pljit/optimization/pass_manager.hpp"
+#include "pljit/persistence/code_cache.hpp"
 #include <string_view>
 
 namespace pljit {
@@ -18,63 +27,312 @@ namespace semantic_analysis {
 class FunctionNode;
 } // namespace semantic_analysis
 
+/// Engines a function can be executed with
+enum class execution_engine {
+    /// Walks the AST on every call
+    INTERPRETER,
+    /// Generates machine code for the host, falls back to the interpreter if that is not supported
+    NATIVE,
+    /// Runs register bytecode in a portable virtual machine
+    BYTECODE,
+    /// Compiles the AST into a tree of pre-bound closures
+    CLOSURE,
+    /// Generates machine code by patching pre-assembled stencils, falls back to the interpreter if not supported
+    COPY_AND_PATCH
+};
+
+/// Controls how a function is compiled
+struct function_options {
+    /// Engine the function is (eventually) executed with
+    execution_engine engine = execution_engine::NATIVE;
+    /// If non-zero, the function starts out in the AST interpreter. Once it has been called this often, it is
+    /// optimized and compiled with engine on the worker pool of the Pljit, or by the calling thread for functions
+    /// constructed directly. Otherwise engine is used from the first call on.
+    uint32_t tier_up_threshold = 0;
+    /// Passes run on the AST before code is generated. With tiered execution, they run when the function is promoted.
+    optimization::optimization_level optimization = optimization::optimization_level::O1;
+    /// Compile on the worker pool of the Pljit right after registration instead of on the first call
+    bool background_compilation = false;
+    /// Measure the phases of the compilation, see Function::get_compile_statistics
+    bool collect_compile_statistics = false;
+    /// Count calls and measure their latency, see Pljit::stats_snapshot
+    bool collect_runtime_statistics = false;
+
+    function_options() = default;
+    // Implicit for convenience, register_function(source, execution_engine::BYTECODE)
+    function_options(execution_engine engine, uint32_t tier_up_threshold = 0, optimization::optimization_level optimization = optimization::optimization_level::O1)
+        : engine(engine), tier_up_threshold(tier_up_threshold), optimization(optimization) {}
+    // Implicit for convenience, register_function(source, optimization_level::O2)
+    function_options(optimization::optimization_level optimization) : optimization(optimization) {}
+};
+
+/// How a call behaves while the function is still being compiled in the background
+enum class pending_compilation {
+    /// Block until compilation finished
+    WAIT,
+    /// Analyze and interpret a private copy of the function, without waiting
+    SLOW_PATH,
+    /// Return a failed result right away
+    FAIL
+};
+
 class Function {
-    std::mutex compilation_mutex;
+    friend class Pljit;
+
+    /// Lifecycle of a function, stored in one atomic word. Every state from READY on is compiled.
+    enum class compilation_state : uint32_t {
+        UNCOMPILED,
+        /// One thread compiles, every other caller waits
+        COMPILING,
+        FAILED,
+        READY,
+        /// Tiered execution: the optimized tier is built while callers keep interpreting
+        OPTIMIZING,
+        /// Tiered execution: the tier-up finished, optimized_code is set unless it failed
+        OPTIMIZED
+    };
+    static bool is_compiled(compilation_state state) {
+        return state >= compilation_state::READY;
+    }
+
+    /// Everything below except for the tier-up members is published by the release store of READY
+    std::atomic<uint32_t> state{static_cast<uint32_t>(compilation_state::UNCOMPILED)};
     source_management::SourceCode source_code;
+    function_options options;
+    // Set by Pljit if compiled ASTs are kept on disk
+    const persistence::code_cache* disk_cache = nullptr;
+    std::string disk_cache_key;
     std::unique_ptr<semantic_analysis::FunctionNode> ast;
-    bool compilation_failed = false;
+    // Initial frame of the interpreter, with the constants in place
+    std::vector<int64_t> frame_template;
+    // Set if the engine compiled the AST, otherwise the AST is interpreted
+    std::unique_ptr<execution::compiled_function> compiled_code;
+    std::vector<optimization::pass_statistics> pass_statistics;
+    // Errors reported while analyzing the source
+    std::string diagnostics;
+    // Only collected on request
+    std::unique_ptr<compile_statistics> compilation_statistics;
+    // Allocated on construction if requested, never changes afterwards
+    std::unique_ptr<runtime_statistics> call_statistics;
+
+    // Tiered execution: calls are counted until the optimized code is published
+    std::atomic<uint32_t> call_count{0};
+    std::unique_ptr<execution::compiled_function> optimized_code_storage;
+    std::atomic<const execution::compiled_function*> optimized_code{nullptr};
+    // Set by Pljit, which outlives the tasks it runs. Standalone functions tier up on the calling thread.
+    worker_pool* tier_up_workers = nullptr;
 
 #ifndef NDEBUG
     unsigned int compilation_passed = 0;
 #endif
 
+    /// Runs in state COMPILING on exactly one thread, publishes READY or FAILED
     void compile();
-    execution::ExecutionContext call_impl(std::initializer_list<int64_t>);
+    /// Compiles the function unless that already happened. Lock-free once the function is compiled.
+    /// @return false if compilation failed
+    bool ensure_compiled() {
+        const auto current = static_cast<compilation_state>(state.load(std::memory_order_acquire));
+        if (is_compiled(current)) return true;
+        if (current == compilation_state::FAILED) return false;
+        return compile_slow();
+    }
+    /// Either compiles the function or waits for the thread that does
+    bool compile_slow();
+    std::size_t get_number_of_parameters() const;
+    /// Lexes, parses and analyzes the source code, returns nullptr on errors
+    std::unique_ptr<semantic_analysis::FunctionNode> analyze(compile_statistics* statistics = nullptr) const;
+    /// Builds the optimized tier and publishes it to callers
+    void tier_up();
+    /// Number of arguments for callers that do not know how many parameters they pass
+    static constexpr std::size_t unchecked_arity = std::numeric_limits<std::size_t>::max();
+    /// call that fails without executing anything if number_of_arguments does not match the parameters
+    std::optional<int64_t> call_checked(const int64_t* parameters, std::size_t number_of_arguments, int64_t* frame, pending_compilation policy);
+    /// call_checked without the runtime statistics
+    std::optional<int64_t> call_unmeasured(const int64_t* parameters, std::size_t number_of_arguments, int64_t* frame, pending_compilation policy);
+    std::optional<int64_t> call_impl(const int64_t* parameters, int64_t* frame);
+    /// Slow path while compilation is in flight
+    std::optional<int64_t> interpret_uncompiled(const int64_t* parameters, std::size_t number_of_arguments) const;
 
     public:
-    explicit Function(std::string source);
+    explicit Function(std::string source, function_options options = {});
 
     template <class... Args, class = typename std::enable_if_t<std::conjunction_v<std::is_convertible<Args, int64_t>...>>>
     ExecutionContext operator()(Args... args) {
         static_assert(std::conjunction_v<std::is_convertible<Args, int64_t>...>, "PL supports only int64_t parameters.");
         // std::forward is not superfluous, we may pass arbitrary types convertible to int64_t.
-        if (!ast && !compilation_failed) {
-            // Compile function first
-            compile();
-        }
-        if (compilation_failed) return {};
-        return call_impl({std::forward<Args>(args)...});
+        return call_with(pending_compilation::WAIT, std::forward<Args>(args)...);
+    }
+
+    /// Calls the function, policy decides what happens while it is compiled in the background
+    template <class... Args, class = typename std::enable_if_t<std::conjunction_v<std::is_convertible<Args, int64_t>...>>>
+    ExecutionContext call_with(pending_compilation policy, Args... args) {
+        static_assert(std::conjunction_v<std::is_convertible<Args, int64_t>...>, "PL supports only int64_t parameters.");
+        // One extra slot, arrays of size zero are not allowed
+        const int64_t parameters[sizeof...(Args) + 1] = {std::forward<Args>(args)...};
+        ExecutionContext context;
+        // Fails on a wrong number of arguments before any parameter is read
+        context.set_result(call_checked(parameters, sizeof...(Args), nullptr, policy));
+        return context;
+    }
+
+    /// Whether compilation finished, successfully or not. Never blocks.
+    bool ready() const {
+        const auto current = static_cast<compilation_state>(state.load(std::memory_order_acquire));
+        return is_compiled(current) || current == compilation_state::FAILED;
+    }
+
+    /// Blocks until compilation finished, compiles on the calling thread if nobody else does
+    /// @return false if compilation failed
+    bool wait() {
+        return ensure_compiled();
+    }
+
+    /// Number of int64_t slots a frame passed to call has to provide. Compiles the function if necessary.
+    std::size_t get_frame_size();
+
+    /**
+     * Allocation free call path.
+     * @param parameters One value per declared parameter
+     * @param frame Scratch memory of get_frame_size() slots. If nullptr, a frame on the stack is used for
+     *      small functions and a reused thread local buffer for large ones.
+     * @param policy Behavior while the function is compiled in the background
+     * @return The result or std::nullopt if compilation or execution failed
+     */
+    std::optional<int64_t> call(const int64_t* parameters, int64_t* frame = nullptr, pending_compilation policy = pending_compilation::WAIT);
+
+    /**
+     * Evaluates the function for n parameter tuples. Much cheaper per tuple than calling the function n times.
+     * @param parameter_columns One column of n values per parameter
+     * @param out Receives the result of each tuple
+     * @param error_mask Set to 1 for tuples whose execution failed (e.g. division by zero), 0 otherwise
+     * @return false if the function failed to compile
+     */
+    bool evaluate_batch(const int64_t* const* parameter_columns, std::size_t n, int64_t* out, uint8_t* error_mask);
+
+    /// Whether calls run the optimized tier
+    bool is_optimized() const;
+
+    /// Statistics of the optimization passes run on this function. With tiered execution, only valid once is_optimized().
+    const std::vector<optimization::pass_statistics>& get_pass_statistics() const {
+        return pass_statistics;
+    }
+
+    /**
+     * Phase times and counters of the compilation, nullptr unless function_options::collect_compile_statistics
+     * is set. Only valid once ready(). With tiered execution, the optimization and code generation of the
+     * optimized tier are not included.
+     */
+    const compile_statistics* get_compile_statistics() const {
+        return ready() ? compilation_statistics.get() : nullptr;
     }
+
+    /// Errors reported by the lexer, parser and semantic analysis. Only valid once ready().
+    const std::string& get_diagnostics() const {
+        return diagnostics;
+    }
+
     ~Function();
 };
 
 class function_handle;
+struct registration_result;
 
 class Pljit {
-    std::vector<std::unique_ptr<Function>> registered_functions;
+    function_registry registered_functions;
+    // Deduplicates registrations of the same source
+    compilation_cache compiled_functions;
+    function_options default_options;
+    std::unique_ptr<persistence::code_cache> disk_cache;
+    // Destroyed before the registry, running compilations and tier-ups access registered functions
+    worker_pool compilation_workers;
 
     public:
+    explicit Pljit(function_options default_options = {}) : default_options(default_options) {}
+
+    /// Registering the same source (up to whitespace) with the same options again returns a handle to the same function
     function_handle register_function(std::string source);
+    function_handle register_function(std::string source, function_options options);
 
+    /**
+     * Keeps the analyzed and optimized ASTs of functions registered from now on in directory, and loads
+     * them from there instead of compiling the source if a later process registers the same function.
+     * Must not run concurrently to register_function.
+     */
+    void set_disk_cache(std::filesystem::path directory);
+
+    /**
+     * Registers and compiles a batch of functions in parallel, on the compilation workers and the calling thread.
+     * Errors are not printed but returned in the results, which are in the order of sources.
+     */
+    std::vector<registration_result> register_functions(std::vector<std::string> sources);
+    std::vector<registration_result> register_functions(std::vector<std::string> sources, function_options options);
+
+    /**
+     * Compiles every function registered so far to bytecode and writes them into one image, which
+     * persistence::snapshot_image::load maps in another process. Ids are preserved.
+     * @return false if the image could not be written
+     */
+    bool save_image(const std::filesystem::path& path);
+
+    /// Sum of the statistics of all compiled functions that collect them
+    compile_statistics get_compile_statistics();
+
+    /// Call statistics of every function registered with function_options::collect_runtime_statistics, by id
+    statistics_snapshot stats_snapshot();
+
+    /// Lock-free, may run concurrently to register_function
     Function& get(unsigned id) {
-        return *registered_functions[id];
+        return registered_functions.get(id);
     }
 };
 
 class function_handle {
     friend Pljit;
-    Pljit* pljit;
+    // Resolved at registration, functions never move
+    Function* function;
     unsigned function_id;
 
-    explicit function_handle(Pljit* pljit, unsigned function_id) : pljit(pljit), function_id(function_id){};
+    explicit function_handle(Function* function, unsigned function_id) : function(function), function_id(function_id){};
 
     public:
     template <class... Args, class = typename std::enable_if_t<std::conjunction_v<std::is_convertible<Args, int64_t>...>>>
     ExecutionContext operator()(Args... args) {
         static_assert(std::conjunction_v<std::is_convertible<Args, int64_t>...>, "PL supports only int64_t parameters.");
         // std::forward is not superfluous, we may pass arbitrary types convertible to int64_t.
-        return pljit->get(function_id)(std::forward<Args>(args)...);
+        return (*function)(std::forward<Args>(args)...);
     }
+
+    template <class... Args, class = typename std::enable_if_t<std::conjunction_v<std::is_convertible<Args, int64_t>...>>>
+    ExecutionContext call_with(pending_compilation policy, Args... args) {
+        return function->call_with(policy, std::forward<Args>(args)...);
+    }
+
+    /// Whether compilation finished, successfully or not
+    bool ready() const {
+        return function->ready();
+    }
+
+    /// Blocks until compilation finished
+    /// @return false if compilation failed
+    bool wait() {
+        return function->wait();
+    }
+
+    unsigned get_id() const {
+        return function_id;
+    }
+
+    /// Errors reported while compiling the function, only valid once ready()
+    const std::string& get_diagnostics() const {
+        return function->get_diagnostics();
+    }
+};
+
+struct registration_result {
+    function_handle handle;
+    bool success;
+    /// Owned by the function, empty if compilation succeeded
+    std::string_view diagnostics;
 };
 
 } // namespace pljit
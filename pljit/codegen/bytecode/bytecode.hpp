@@ -0,0 +1,55 @@
+#ifndef PLJIT_BYTECODE_HPP
+#define PLJIT_BYTECODE_HPP
+
+#include <cstdint>
+#include <vector>
+
+namespace pljit::codegen::bytecode {
+
+/**
+ * Operations of the register machine. All operands are register indices:
+ *      [0, #symbols)           symbols, indexed by their symbol_table id
+ *      [#symbols, #registers)  literals and temporaries
+ * Constants and literals are preloaded into their registers, so no operation takes an immediate.
+ */
+enum class opcode : uint32_t {
+    /// destination := lhs
+    MOVE,
+    /// destination := -lhs
+    NEGATE,
+    /// destination := lhs <op> rhs
+    ADD,
+    SUBTRACT,
+    MULTIPLY,
+    /// Fails on division by zero
+    DIVIDE,
+    /// Returns lhs
+    RETURN
+};
+
+struct instruction {
+    opcode operation;
+    uint32_t destination;
+    uint32_t lhs;
+    uint32_t rhs;
+};
+
+struct program {
+    std::vector<instruction> instructions;
+    /// Initial register contents: constants and literals are set, everything else is zero
+    std::vector<int64_t> register_template;
+    uint32_t number_of_parameters = 0;
+};
+
+/// Non-owning view of a program, e.g. one stored in a mapped snapshot image
+struct program_view {
+    const instruction* instructions;
+    uint32_t number_of_instructions;
+    const int64_t* register_template;
+    uint32_t number_of_registers;
+    uint32_t number_of_parameters;
+};
+
+} // namespace pljit::codegen::bytecode
+
+#endif //PLJIT_BYTECODE_HPP
@@ -0,0 +1,99 @@
+#include "bytecode_function.hpp"
+#include "pljit/execution/arithmetic.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <utility>
+
+namespace pljit::codegen::bytecode {
+
+using namespace pljit::execution;
+
+namespace {
+#if defined(__GNUC__)
+// Labels as values are a GNU extension
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpedantic"
+#endif
+std::optional<int64_t> dispatch(const instruction* ip, int64_t* registers) {
+#if defined(__GNUC__)
+    // Threaded dispatch: every handler jumps directly to the handler of the next instruction
+    static const void* const handlers[] = {&&MOVE, &&NEGATE, &&ADD, &&SUBTRACT, &&MULTIPLY, &&DIVIDE, &&RETURN};
+#define DISPATCH() goto* handlers[static_cast<uint32_t>(ip->operation)]
+#define HANDLER(name) name
+#define NEXT() \
+    ++ip;      \
+    DISPATCH()
+
+    DISPATCH();
+#else
+#define HANDLER(name) case opcode::name
+#define NEXT() \
+    ++ip;      \
+    continue
+
+    for (;;) {
+        switch (ip->operation) {
+#endif
+    HANDLER(MOVE) : {
+        registers[ip->destination] = registers[ip->lhs];
+        NEXT();
+    }
+    HANDLER(NEGATE) : {
+        registers[ip->destination] = wrapping_negate(registers[ip->lhs]);
+        NEXT();
+    }
+    HANDLER(ADD) : {
+        registers[ip->destination] = wrapping_add(registers[ip->lhs], registers[ip->rhs]);
+        NEXT();
+    }
+    HANDLER(SUBTRACT) : {
+        registers[ip->destination] = wrapping_subtract(registers[ip->lhs], registers[ip->rhs]);
+        NEXT();
+    }
+    HANDLER(MULTIPLY) : {
+        registers[ip->destination] = wrapping_multiply(registers[ip->lhs], registers[ip->rhs]);
+        NEXT();
+    }
+    HANDLER(DIVIDE) : {
+        const int64_t divisor = registers[ip->rhs];
+        if (divisor == 0) {
+            report_division_by_zero();
+            return std::nullopt;
+        }
+        registers[ip->destination] = wrapping_divide(registers[ip->lhs], divisor);
+        NEXT();
+    }
+    HANDLER(RETURN) : {
+        return registers[ip->lhs];
+    }
+#if !defined(__GNUC__)
+        }
+    }
+#endif
+#undef DISPATCH
+#undef HANDLER
+#undef NEXT
+}
+#if defined(__GNUC__)
+#pragma GCC diagnostic pop
+#endif
+} // namespace
+
+bytecode_function::bytecode_function(program code) : code(std::move(code)) {
+    assert(!this->code.instructions.empty() && this->code.instructions.back().operation == opcode::RETURN);
+}
+
+std::optional<int64_t> execute(const program_view& code, const int64_t* parameters, int64_t* frame) {
+    std::copy(code.register_template, code.register_template + code.number_of_registers, frame);
+    std::copy(parameters, parameters + code.number_of_parameters, frame);
+    return dispatch(code.instructions, frame);
+}
+
+std::optional<int64_t> bytecode_function::execute_impl(const int64_t* parameters, int64_t* frame) const {
+    const program_view view{code.instructions.data(), static_cast<uint32_t>(code.instructions.size()), code.register_template.data(),
+                            static_cast<uint32_t>(code.register_template.size()), code.number_of_parameters};
+    return bytecode::execute(view, parameters, frame);
+}
+
+} // namespace pljit::codegen::bytecode
@@ -0,0 +1,37 @@
+#ifndef PLJIT_BYTECODE_FUNCTION_HPP
+#define PLJIT_BYTECODE_FUNCTION_HPP
+
+#include "pljit/codegen/bytecode/bytecode.hpp"
+#include "pljit/execution/compiled_function.hpp"
+
+namespace pljit::codegen::bytecode {
+
+/**
+ * Runs code on frame, which has to provide code.number_of_registers slots.
+ * @return The result or std::nullopt on division by zero
+ */
+std::optional<int64_t> execute(const program_view& code, const int64_t* parameters, int64_t* frame);
+
+/// Runs a bytecode program on a register file initialized from the program's register template
+class bytecode_function : public execution::compiled_function {
+    program code;
+
+    protected:
+    std::optional<int64_t> execute_impl(const int64_t* parameters, int64_t* frame) const override;
+
+    public:
+    explicit bytecode_function(program code);
+
+    /// The frame holds the register file
+    std::size_t get_frame_size() const override {
+        return code.register_template.size();
+    }
+
+    const program& get_program() const {
+        return code;
+    }
+};
+
+} // namespace pljit::codegen::bytecode
+
+#endif //PLJIT_BYTECODE_FUNCTION_HPP
@@ -0,0 +1,134 @@
+#include "bytecode_generator.hpp"
+#include "pljit/codegen/bytecode/bytecode_function.hpp"
+#include "pljit/semantic_analysis/AST.hpp"
+#include <algorithm>
+
+using namespace pljit::semantic_analysis;
+
+namespace pljit::codegen::bytecode {
+
+bytecode_generator::bytecode_generator(const symbol_table& symbols) {
+    code.number_of_parameters = static_cast<uint32_t>(symbols.get_number_of_parameters());
+    code.register_template.resize(symbols.size(), 0);
+    for (auto constant = symbols.constants_begin(); constant != symbols.constants_end(); ++constant) {
+        code.register_template[constant->id] = constant->get_value();
+    }
+}
+
+uint32_t bytecode_generator::evaluate(ExpressionNode& node, std::optional<uint32_t> destination) {
+    requested_destination = destination;
+    node.accept(*this);
+    requested_destination.reset();
+    return result_register;
+}
+
+uint32_t bytecode_generator::allocate_temporary() {
+    uint32_t temporary = next_temporary++;
+    number_of_temporaries = std::max(number_of_temporaries, next_temporary);
+    return temporary | temporary_flag;
+}
+
+uint32_t bytecode_generator::literal_register(int64_t value) {
+    if (auto iter = literal_registers.find(value); iter != literal_registers.end()) {
+        return iter->second;
+    }
+    auto id = static_cast<uint32_t>(code.register_template.size());
+    code.register_template.push_back(value);
+    literal_registers.emplace(value, id);
+    return id;
+}
+
+void bytecode_generator::emit(opcode operation, uint32_t destination, uint32_t lhs, uint32_t rhs) {
+    code.instructions.push_back({operation, destination, lhs, rhs});
+}
+
+void bytecode_generator::visit(FunctionNode& node) {
+    for (unsigned i = 0; i < node.get_number_of_statements(); ++i) {
+        node.get_statement(i)->accept(*this);
+        // Anything after the first return is unreachable
+        if (node.get_statement(i)->getType() == ASTNode::ReturnStatement) break;
+    }
+}
+
+void bytecode_generator::visit(IdentifierNode& node) {
+    const uint32_t source = static_cast<uint32_t>(node.get_symbol_handle());
+    if (requested_destination && *requested_destination != source) {
+        emit(opcode::MOVE, *requested_destination, source);
+        result_register = *requested_destination;
+    } else {
+        result_register = source;
+    }
+}
+
+void bytecode_generator::visit(LiteralNode& node) {
+    const uint32_t source = literal_register(node.get_value());
+    if (requested_destination) {
+        emit(opcode::MOVE, *requested_destination, source);
+        result_register = *requested_destination;
+    } else {
+        result_register = source;
+    }
+}
+
+void bytecode_generator::visit(ReturnStatementNode& node) {
+    emit(opcode::RETURN, 0, evaluate(node.get_expression()));
+}
+
+void bytecode_generator::visit(AssignmentNode& node) {
+    evaluate(node.get_expression(), static_cast<uint32_t>(node.get_identifier().get_symbol_handle()));
+}
+
+void bytecode_generator::visit(UnaryOperatorASTNode& node) {
+    auto destination = requested_destination;
+    if (node.get_operator() == UnaryOperatorASTNode::OperatorType::PLUS) {
+        result_register = evaluate(node.getInput(), destination);
+        return;
+    }
+    const uint32_t mark = next_temporary;
+    const uint32_t input = evaluate(node.getInput());
+    // Operands are dead once the instruction executed, their temporaries can be reused for the result
+    next_temporary = mark;
+    result_register = destination ? *destination : allocate_temporary();
+    emit(opcode::NEGATE, result_register, input);
+}
+
+void bytecode_generator::visit(BinaryOperatorASTNode& node) {
+    auto destination = requested_destination;
+    const uint32_t mark = next_temporary;
+    const uint32_t lhs = evaluate(node.getLeft());
+    const uint32_t rhs = evaluate(node.getRight());
+    next_temporary = mark;
+    result_register = destination ? *destination : allocate_temporary();
+
+    switch (node.get_operator()) {
+        case BinaryOperatorASTNode::OperatorType::PLUS: emit(opcode::ADD, result_register, lhs, rhs); break;
+        case BinaryOperatorASTNode::OperatorType::MINUS: emit(opcode::SUBTRACT, result_register, lhs, rhs); break;
+        case BinaryOperatorASTNode::OperatorType::MULTIPLY: emit(opcode::MULTIPLY, result_register, lhs, rhs); break;
+        case BinaryOperatorASTNode::OperatorType::DIVIDE: emit(opcode::DIVIDE, result_register, lhs, rhs); break;
+    }
+}
+
+program bytecode_generator::generate(FunctionNode& function) {
+    bytecode_generator generator(function.getSymbolTable());
+    function.accept(generator);
+
+    // The number of literal registers is only known now, place the temporaries behind them
+    auto& code = generator.code;
+    const auto temporaries_base = static_cast<uint32_t>(code.register_template.size());
+    auto relocate = [temporaries_base](uint32_t& operand) {
+        if (operand & temporary_flag) operand = temporaries_base + (operand & ~temporary_flag);
+    };
+    for (auto& instruction : code.instructions) {
+        relocate(instruction.destination);
+        relocate(instruction.lhs);
+        relocate(instruction.rhs);
+    }
+    code.register_template.resize(code.register_template.size() + generator.number_of_temporaries, 0);
+    return std::move(code);
+}
+
+std::unique_ptr<execution::compiled_function> bytecode_generator::compile(FunctionNode& function) {
+    return std::make_unique<bytecode_function>(generate(function));
+}
+
+} // namespace pljit::codegen::bytecode
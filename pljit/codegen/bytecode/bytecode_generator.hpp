@@ -0,0 +1,53 @@
+#ifndef PLJIT_BYTECODE_GENERATOR_HPP
+#define PLJIT_BYTECODE_GENERATOR_HPP
+
+#include "pljit/codegen/bytecode/bytecode.hpp"
+#include "pljit/execution/compiled_function.hpp"
+#include "pljit/semantic_analysis/ast_visitor.hpp"
+#include "pljit/semantic_analysis/symbol_table.hpp"
+#include <memory>
+#include <optional>
+#include <unordered_map>
+
+namespace pljit::codegen::bytecode {
+
+/**
+ * Emits register bytecode for an AST. Temporaries are allocated in stack order; the root of an assigned
+ * expression writes straight into the register of the assigned symbol.
+ */
+class bytecode_generator : public semantic_analysis::ast_visitor {
+    program code;
+    std::unordered_map<int64_t, uint32_t> literal_registers;
+    /// Marks temporaries until they are relocated behind the literal registers
+    static constexpr uint32_t temporary_flag = 1u << 31;
+    uint32_t next_temporary = 0;
+    uint32_t number_of_temporaries = 0;
+
+    /// Register that should receive the value of the visited expression, if any
+    std::optional<uint32_t> requested_destination;
+    /// Register holding the value of the last visited expression
+    uint32_t result_register = 0;
+
+    explicit bytecode_generator(const semantic_analysis::symbol_table& symbols);
+
+    uint32_t evaluate(semantic_analysis::ExpressionNode& node, std::optional<uint32_t> destination = std::nullopt);
+    uint32_t allocate_temporary();
+    uint32_t literal_register(int64_t value);
+    void emit(opcode operation, uint32_t destination, uint32_t lhs, uint32_t rhs = 0);
+
+    public:
+    void visit(semantic_analysis::FunctionNode& node) override;
+    void visit(semantic_analysis::IdentifierNode& node) override;
+    void visit(semantic_analysis::LiteralNode& node) override;
+    void visit(semantic_analysis::ReturnStatementNode& node) override;
+    void visit(semantic_analysis::AssignmentNode& node) override;
+    void visit(semantic_analysis::UnaryOperatorASTNode& node) override;
+    void visit(semantic_analysis::BinaryOperatorASTNode& node) override;
+
+    static program generate(semantic_analysis::FunctionNode& function);
+    static std::unique_ptr<execution::compiled_function> compile(semantic_analysis::FunctionNode& function);
+};
+
+} // namespace pljit::codegen::bytecode
+
+#endif //PLJIT_BYTECODE_GENERATOR_HPP
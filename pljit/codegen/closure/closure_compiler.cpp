@@ -0,0 +1,187 @@
+#include "closure_compiler.hpp"
+#include "pljit/execution/arithmetic.hpp"
+#include "pljit/semantic_analysis/AST.hpp"
+
+using namespace pljit::semantic_analysis;
+using namespace pljit::execution;
+
+namespace pljit::codegen::closure {
+
+namespace {
+using operand_kind = closure_compiler::operand_kind;
+
+template <operand_kind kind>
+int64_t fetch(const closure* child, int64_t operand, int64_t* frame, bool& failed) {
+    if constexpr (kind == operand_kind::CLOSURE) {
+        return (*child)(frame, failed);
+    } else if constexpr (kind == operand_kind::SLOT) {
+        return frame[operand];
+    } else {
+        return operand;
+    }
+}
+
+struct add_operation {
+    static int64_t apply(int64_t lhs, int64_t rhs, bool&) { return wrapping_add(lhs, rhs); }
+};
+struct subtract_operation {
+    static int64_t apply(int64_t lhs, int64_t rhs, bool&) { return wrapping_subtract(lhs, rhs); }
+};
+struct multiply_operation {
+    static int64_t apply(int64_t lhs, int64_t rhs, bool&) { return wrapping_multiply(lhs, rhs); }
+};
+struct divide_operation {
+    static int64_t apply(int64_t lhs, int64_t rhs, bool& failed) {
+        if (rhs == 0) {
+            failed = true;
+            return 0;
+        }
+        return wrapping_divide(lhs, rhs);
+    }
+};
+
+template <operand_kind kind>
+int64_t load(const closure& self, int64_t* frame, bool& failed) {
+    return fetch<kind>(self.lhs, self.lhs_operand, frame, failed);
+}
+
+template <operand_kind kind>
+int64_t negate(const closure& self, int64_t* frame, bool& failed) {
+    return wrapping_negate(fetch<kind>(self.lhs, self.lhs_operand, frame, failed));
+}
+
+template <class operation, operand_kind lhs, operand_kind rhs>
+int64_t binary(const closure& self, int64_t* frame, bool& failed) {
+    const int64_t lhs_value = fetch<lhs>(self.lhs, self.lhs_operand, frame, failed);
+    const int64_t rhs_value = fetch<rhs>(self.rhs, self.rhs_operand, frame, failed);
+    return operation::apply(lhs_value, rhs_value, failed);
+}
+
+template <template <operand_kind> class selector>
+closure::evaluate_fn select(operand_kind kind) {
+    switch (kind) {
+        case operand_kind::CLOSURE: return selector<operand_kind::CLOSURE>::value;
+        case operand_kind::SLOT: return selector<operand_kind::SLOT>::value;
+        case operand_kind::CONSTANT: return selector<operand_kind::CONSTANT>::value;
+    }
+    return nullptr;
+}
+
+template <operand_kind kind>
+struct load_selector {
+    static constexpr closure::evaluate_fn value = &load<kind>;
+};
+template <operand_kind kind>
+struct negate_selector {
+    static constexpr closure::evaluate_fn value = &negate<kind>;
+};
+template <class operation, operand_kind lhs>
+struct binary_selector {
+    template <operand_kind rhs>
+    struct with_rhs {
+        static constexpr closure::evaluate_fn value = &binary<operation, lhs, rhs>;
+    };
+};
+
+template <class operation>
+closure::evaluate_fn select_binary(operand_kind lhs, operand_kind rhs) {
+    switch (lhs) {
+        case operand_kind::CLOSURE: return select<binary_selector<operation, operand_kind::CLOSURE>::template with_rhs>(rhs);
+        case operand_kind::SLOT: return select<binary_selector<operation, operand_kind::SLOT>::template with_rhs>(rhs);
+        case operand_kind::CONSTANT: return select<binary_selector<operation, operand_kind::CONSTANT>::template with_rhs>(rhs);
+    }
+    return nullptr;
+}
+} // namespace
+
+closure_compiler::closure_compiler(closure_function& function, const symbol_table& symbols) : function(function), symbols(symbols) {}
+
+auto closure_compiler::compile_operand(ExpressionNode& node) -> operand {
+    node.accept(*this);
+    return result;
+}
+
+const closure* closure_compiler::compile_expression(ExpressionNode& node) {
+    auto expression = compile_operand(node);
+    if (expression.kind == operand_kind::CLOSURE) return expression.child;
+    closure leaf;
+    leaf.evaluate = select<load_selector>(expression.kind);
+    leaf.lhs_operand = expression.value;
+    return add(leaf);
+}
+
+const closure* closure_compiler::add(closure node) {
+    return &function.closures.emplace_back(node);
+}
+
+void closure_compiler::visit(FunctionNode& node) {
+    for (unsigned i = 0; i < node.get_number_of_statements(); ++i) {
+        node.get_statement(i)->accept(*this);
+        // Anything after the first return is unreachable
+        if (function.return_expression) break;
+    }
+}
+
+void closure_compiler::visit(IdentifierNode& node) {
+    const auto& symbol = symbols.get(node.get_symbol_handle());
+    if (symbol.type == symbol::CONSTANT) {
+        result = {operand_kind::CONSTANT, nullptr, symbol.get_value()};
+    } else {
+        result = {operand_kind::SLOT, nullptr, static_cast<int64_t>(node.get_symbol_handle())};
+    }
+}
+
+void closure_compiler::visit(LiteralNode& node) {
+    result = {operand_kind::CONSTANT, nullptr, node.get_value()};
+}
+
+void closure_compiler::visit(ReturnStatementNode& node) {
+    function.return_expression = compile_expression(node.get_expression());
+}
+
+void closure_compiler::visit(AssignmentNode& node) {
+    function.assignments.push_back({node.get_identifier().get_symbol_handle(), compile_expression(node.get_expression())});
+}
+
+void closure_compiler::visit(UnaryOperatorASTNode& node) {
+    auto input = compile_operand(node.getInput());
+    if (node.get_operator() == UnaryOperatorASTNode::OperatorType::PLUS) {
+        result = input;
+        return;
+    }
+    closure negation;
+    negation.evaluate = select<negate_selector>(input.kind);
+    negation.lhs = input.child;
+    negation.lhs_operand = input.value;
+    result = {operand_kind::CLOSURE, add(negation), 0};
+}
+
+void closure_compiler::visit(BinaryOperatorASTNode& node) {
+    auto lhs = compile_operand(node.getLeft());
+    auto rhs = compile_operand(node.getRight());
+
+    closure operation;
+    switch (node.get_operator()) {
+        case BinaryOperatorASTNode::OperatorType::PLUS: operation.evaluate = select_binary<add_operation>(lhs.kind, rhs.kind); break;
+        case BinaryOperatorASTNode::OperatorType::MINUS: operation.evaluate = select_binary<subtract_operation>(lhs.kind, rhs.kind); break;
+        case BinaryOperatorASTNode::OperatorType::MULTIPLY: operation.evaluate = select_binary<multiply_operation>(lhs.kind, rhs.kind); break;
+        case BinaryOperatorASTNode::OperatorType::DIVIDE: operation.evaluate = select_binary<divide_operation>(lhs.kind, rhs.kind); break;
+    }
+    operation.lhs = lhs.child;
+    operation.lhs_operand = lhs.value;
+    operation.rhs = rhs.child;
+    operation.rhs_operand = rhs.value;
+    result = {operand_kind::CLOSURE, add(operation), 0};
+}
+
+std::unique_ptr<execution::compiled_function> closure_compiler::compile(FunctionNode& function) {
+    auto compiled = std::make_unique<closure_function>();
+    compiled->frame_size = function.getSymbolTable().size();
+    compiled->number_of_parameters = function.getSymbolTable().get_number_of_parameters();
+
+    closure_compiler compiler(*compiled, function.getSymbolTable());
+    function.accept(compiler);
+    return compiled;
+}
+
+} // namespace pljit::codegen::closure
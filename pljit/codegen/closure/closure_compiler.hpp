@@ -0,0 +1,52 @@
+#ifndef PLJIT_CLOSURE_COMPILER_HPP
+#define PLJIT_CLOSURE_COMPILER_HPP
+
+#include "pljit/codegen/closure/closure_function.hpp"
+#include "pljit/semantic_analysis/ast_visitor.hpp"
+#include "pljit/semantic_analysis/symbol_table.hpp"
+#include <memory>
+
+namespace pljit::codegen::closure {
+
+/// Turns an AST into a tree of closures once, so calls neither dispatch on node types nor propagate optionals
+class closure_compiler : public semantic_analysis::ast_visitor {
+    public:
+    enum class operand_kind {
+        CLOSURE,
+        SLOT,
+        CONSTANT
+    };
+
+    private:
+    struct operand {
+        operand_kind kind;
+        const closure* child;
+        int64_t value;
+    };
+
+    closure_function& function;
+    const semantic_analysis::symbol_table& symbols;
+    /// Operand the last visited expression evaluates to
+    operand result{operand_kind::CONSTANT, nullptr, 0};
+
+    closure_compiler(closure_function& function, const semantic_analysis::symbol_table& symbols);
+
+    operand compile_operand(semantic_analysis::ExpressionNode& node);
+    const closure* compile_expression(semantic_analysis::ExpressionNode& node);
+    const closure* add(closure node);
+
+    public:
+    void visit(semantic_analysis::FunctionNode& node) override;
+    void visit(semantic_analysis::IdentifierNode& node) override;
+    void visit(semantic_analysis::LiteralNode& node) override;
+    void visit(semantic_analysis::ReturnStatementNode& node) override;
+    void visit(semantic_analysis::AssignmentNode& node) override;
+    void visit(semantic_analysis::UnaryOperatorASTNode& node) override;
+    void visit(semantic_analysis::BinaryOperatorASTNode& node) override;
+
+    static std::unique_ptr<execution::compiled_function> compile(semantic_analysis::FunctionNode& function);
+};
+
+} // namespace pljit::codegen::closure
+
+#endif //PLJIT_CLOSURE_COMPILER_HPP
@@ -0,0 +1,24 @@
+#include "closure_function.hpp"
+#include "pljit/execution/arithmetic.hpp"
+#include <algorithm>
+
+namespace pljit::codegen::closure {
+
+std::optional<int64_t> closure_function::execute_impl(const int64_t* parameters, int64_t* frame) const {
+    std::copy(parameters, parameters + number_of_parameters, frame);
+    // Variables start out as 0, x := x + 1 may read one before its first assignment
+    std::fill(frame + number_of_parameters, frame + frame_size, 0);
+
+    bool failed = false;
+    for (const auto& assignment : assignments) {
+        frame[assignment.slot] = (*assignment.expression)(frame, failed);
+    }
+    const int64_t result = (*return_expression)(frame, failed);
+    if (failed) {
+        execution::report_division_by_zero();
+        return std::nullopt;
+    }
+    return result;
+}
+
+} // namespace pljit::codegen::closure
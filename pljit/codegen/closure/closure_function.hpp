@@ -0,0 +1,57 @@
+#ifndef PLJIT_CLOSURE_FUNCTION_HPP
+#define PLJIT_CLOSURE_FUNCTION_HPP
+
+#include "pljit/execution/compiled_function.hpp"
+#include <deque>
+#include <vector>
+
+namespace pljit::codegen::closure {
+
+/**
+ * Pre-bound evaluation of an expression. evaluate is specialized for the operation and the kind of its operands,
+ * so leaf operands are read directly from the frame or from the closure instead of through another call.
+ * Errors set failed and evaluation continues with an arbitrary value - expressions have no side effects.
+ */
+struct closure {
+    using evaluate_fn = int64_t (*)(const closure& self, int64_t* frame, bool& failed);
+
+    evaluate_fn evaluate = nullptr;
+    const closure* lhs = nullptr;
+    const closure* rhs = nullptr;
+    /// Frame slot or value of leaf operands
+    int64_t lhs_operand = 0;
+    int64_t rhs_operand = 0;
+
+    int64_t operator()(int64_t* frame, bool& failed) const {
+        return evaluate(*this, frame, failed);
+    }
+};
+
+class closure_function : public execution::compiled_function {
+    friend class closure_compiler;
+
+    struct assignment {
+        std::size_t slot;
+        const closure* expression;
+    };
+
+    /// Owns all closures, a deque keeps their addresses stable
+    std::deque<closure> closures;
+    std::vector<assignment> assignments;
+    const closure* return_expression = nullptr;
+    std::size_t frame_size = 0;
+    std::size_t number_of_parameters = 0;
+
+    protected:
+    std::optional<int64_t> execute_impl(const int64_t* parameters, int64_t* frame) const override;
+
+    public:
+    /// The frame holds one slot per symbol
+    std::size_t get_frame_size() const override {
+        return frame_size;
+    }
+};
+
+} // namespace pljit::codegen::closure
+
+#endif //PLJIT_CLOSURE_FUNCTION_HPP
@@ -0,0 +1,150 @@
+#include "stencil_compiler.hpp"
+#include "pljit/codegen/native_function.hpp"
+#include "pljit/semantic_analysis/AST.hpp"
+#include <cassert>
+#include <cstring>
+
+using namespace pljit::semantic_analysis;
+
+namespace pljit::codegen::copy_and_patch {
+
+stencil_compiler::stencil_compiler(const symbol_table& symbols) : symbols(symbols) {}
+
+int32_t stencil_compiler::frame_offset(symbol_table::symbol_handle symbol) {
+    return -8 * static_cast<int32_t>(symbol + 1);
+}
+
+void stencil_compiler::copy_and_patch(const stencil& stencil, std::initializer_list<int64_t> values) {
+    const std::size_t base = code.size();
+    code.insert(code.end(), stencil.code, stencil.code + stencil.size);
+
+    auto value = values.begin();
+    for (std::size_t i = 0; i < stencil.number_of_holes; ++i) {
+        const hole& hole = stencil.holes[i];
+        switch (hole.kind) {
+            case hole_kind::VALUE32: {
+                assert(value != values.end());
+                const auto patch = static_cast<int32_t>(*value++);
+                std::memcpy(&code[base + hole.offset], &patch, sizeof(patch));
+                break;
+            }
+            case hole_kind::VALUE64: {
+                assert(value != values.end());
+                const int64_t patch = *value++;
+                std::memcpy(&code[base + hole.offset], &patch, sizeof(patch));
+                break;
+            }
+            case hole_kind::ERROR_TARGET: {
+                // The error exit is appended last, patched once its position is known
+                error_fixups.push_back(base + hole.offset);
+                break;
+            }
+        }
+    }
+    assert(value == values.end());
+}
+
+bool stencil_compiler::load_rhs(ExpressionNode& node) {
+    if (node.getType() == ASTNode::Literal) {
+        copy_and_patch(stencils::load_immediate_rhs, {static_cast<LiteralNode&>(node).get_value()});
+        return true;
+    }
+    if (node.getType() == ASTNode::Identifier) {
+        auto handle = static_cast<IdentifierNode&>(node).get_symbol_handle();
+        if (const auto& symbol = symbols.get(handle); symbol.type == symbol::CONSTANT) {
+            copy_and_patch(stencils::load_immediate_rhs, {symbol.get_value()});
+        } else {
+            copy_and_patch(stencils::load_slot_rhs, {frame_offset(handle)});
+        }
+        return true;
+    }
+    return false;
+}
+
+void stencil_compiler::visit(FunctionNode& node) {
+    // One 8 byte slot per symbol, keeping rsp 16 byte aligned
+    const auto frame_size = static_cast<int64_t>((symbols.size() * 8 + 15) & ~std::size_t{15});
+    copy_and_patch(stencils::prologue, {frame_size});
+    for (symbol_table::size_type i = 0; i < symbols.get_number_of_parameters(); ++i) {
+        copy_and_patch(stencils::copy_parameter, {static_cast<int64_t>(i * 8), frame_offset(i)});
+    }
+    // Variables start out as 0, x := x + 1 may read one before its first assignment
+    const auto end_of_variables = symbols.get_number_of_parameters() + symbols.get_number_of_variables();
+    for (auto i = symbols.get_number_of_parameters(); i < end_of_variables; ++i) {
+        copy_and_patch(stencils::zero_slot, {frame_offset(i)});
+    }
+
+    for (unsigned i = 0; i < node.get_number_of_statements(); ++i) {
+        node.get_statement(i)->accept(*this);
+        // Anything after the first return is unreachable
+        if (node.get_statement(i)->getType() == ASTNode::ReturnStatement) break;
+    }
+
+    const std::size_t error_exit = code.size();
+    copy_and_patch(stencils::error_exit);
+    for (auto fixup : error_fixups) {
+        const auto displacement = static_cast<int32_t>(static_cast<int64_t>(error_exit) - static_cast<int64_t>(fixup + sizeof(int32_t)));
+        std::memcpy(&code[fixup], &displacement, sizeof(displacement));
+    }
+}
+
+void stencil_compiler::visit(IdentifierNode& node) {
+    if (const auto& symbol = symbols.get(node.get_symbol_handle()); symbol.type == symbol::CONSTANT) {
+        copy_and_patch(stencils::load_immediate, {symbol.get_value()});
+    } else {
+        copy_and_patch(stencils::load_slot, {frame_offset(node.get_symbol_handle())});
+    }
+}
+
+void stencil_compiler::visit(LiteralNode& node) {
+    copy_and_patch(stencils::load_immediate, {node.get_value()});
+}
+
+void stencil_compiler::visit(ReturnStatementNode& node) {
+    node.get_expression().accept(*this);
+    copy_and_patch(stencils::return_value);
+}
+
+void stencil_compiler::visit(AssignmentNode& node) {
+    node.get_expression().accept(*this);
+    copy_and_patch(stencils::store_slot, {frame_offset(node.get_identifier().get_symbol_handle())});
+}
+
+void stencil_compiler::visit(UnaryOperatorASTNode& node) {
+    node.getInput().accept(*this);
+    if (node.get_operator() == UnaryOperatorASTNode::OperatorType::MINUS) {
+        copy_and_patch(stencils::negate);
+    }
+}
+
+void stencil_compiler::visit(BinaryOperatorASTNode& node) {
+    node.getLeft().accept(*this);
+    if (!load_rhs(node.getRight())) {
+        copy_and_patch(stencils::push_lhs);
+        node.getRight().accept(*this);
+        copy_and_patch(stencils::pop_lhs);
+    }
+
+    switch (node.get_operator()) {
+        case BinaryOperatorASTNode::OperatorType::PLUS: copy_and_patch(stencils::add); break;
+        case BinaryOperatorASTNode::OperatorType::MINUS: copy_and_patch(stencils::subtract); break;
+        case BinaryOperatorASTNode::OperatorType::MULTIPLY: copy_and_patch(stencils::multiply); break;
+        case BinaryOperatorASTNode::OperatorType::DIVIDE: copy_and_patch(stencils::divide); break;
+    }
+}
+
+std::unique_ptr<execution::compiled_function> stencil_compiler::compile(FunctionNode& function) {
+#if defined(__x86_64__) && defined(__unix__)
+    stencil_compiler compiler(function.getSymbolTable());
+    function.accept(compiler);
+
+    auto memory = executable_memory::allocate(compiler.code);
+    if (!memory) return nullptr;
+    return std::make_unique<native_function>(std::move(*memory));
+#else
+    (void) function;
+    return nullptr;
+#endif
+}
+
+} // namespace pljit::codegen::copy_and_patch
@@ -0,0 +1,48 @@
+#ifndef PLJIT_STENCIL_COMPILER_HPP
+#define PLJIT_STENCIL_COMPILER_HPP
+
+#include "pljit/codegen/copy_and_patch/stencils.hpp"
+#include "pljit/execution/compiled_function.hpp"
+#include "pljit/semantic_analysis/ast_visitor.hpp"
+#include "pljit/semantic_analysis/symbol_table.hpp"
+#include <initializer_list>
+#include <memory>
+#include <vector>
+
+namespace pljit::codegen::copy_and_patch {
+
+/**
+ * Copy-and-patch compiler: emits machine code by concatenating pre-assembled stencils and filling in their
+ * holes. There is no instruction selection or encoding at compile time, which keeps compilation latency low
+ * at the cost of less efficient code than the x86-64 code generator.
+ */
+class stencil_compiler : public semantic_analysis::ast_visitor {
+    std::vector<uint8_t> code;
+    /// Offsets of rel32 fields jumping to the error exit
+    std::vector<std::size_t> error_fixups;
+    const semantic_analysis::symbol_table& symbols;
+
+    explicit stencil_compiler(const semantic_analysis::symbol_table& symbols);
+
+    static int32_t frame_offset(semantic_analysis::symbol_table::symbol_handle symbol);
+    /// Copies the stencil and fills its holes with values, in order. Error targets take no value.
+    void copy_and_patch(const stencil& stencil, std::initializer_list<int64_t> values = {});
+    /// Loads a literal or identifier into rcx, returns false for any other node
+    bool load_rhs(semantic_analysis::ExpressionNode& node);
+
+    public:
+    void visit(semantic_analysis::FunctionNode& node) override;
+    void visit(semantic_analysis::IdentifierNode& node) override;
+    void visit(semantic_analysis::LiteralNode& node) override;
+    void visit(semantic_analysis::ReturnStatementNode& node) override;
+    void visit(semantic_analysis::AssignmentNode& node) override;
+    void visit(semantic_analysis::UnaryOperatorASTNode& node) override;
+    void visit(semantic_analysis::BinaryOperatorASTNode& node) override;
+
+    /// @return The machine code of the function or nullptr if native code cannot be generated on this platform
+    static std::unique_ptr<execution::compiled_function> compile(semantic_analysis::FunctionNode& function);
+};
+
+} // namespace pljit::codegen::copy_and_patch
+
+#endif //PLJIT_STENCIL_COMPILER_HPP
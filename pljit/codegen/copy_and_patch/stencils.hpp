@@ -0,0 +1,111 @@
+#ifndef PLJIT_STENCILS_HPP
+#define PLJIT_STENCILS_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace pljit::codegen::copy_and_patch {
+
+/// Kinds of holes a stencil leaves for the compiler to fill in
+enum class hole_kind : uint8_t {
+    /// 32 bit little endian value, e.g. a frame displacement
+    VALUE32,
+    /// 64 bit little endian value
+    VALUE64,
+    /// rel32 jump displacement to the shared error exit
+    ERROR_TARGET
+};
+
+struct hole {
+    uint8_t offset;
+    hole_kind kind;
+};
+
+/**
+ * Pre-assembled x86-64 machine code of one operation. Stencils use the same conventions as the native code
+ * generator: the value of an expression is kept in rax, the right hand side of a binary operation in rcx,
+ * pending left hand sides on the machine stack and all symbols in [rbp - 8 * (id + 1)].
+ */
+struct stencil {
+    const uint8_t* code;
+    std::size_t size;
+    std::array<hole, 2> holes;
+    std::size_t number_of_holes;
+};
+
+namespace stencil_code {
+// push rbp; mov rbp, rsp; sub rsp, <frame size>
+inline constexpr uint8_t prologue[] = {0x55, 0x48, 0x89, 0xE5, 0x48, 0x81, 0xEC, 0, 0, 0, 0};
+// mov rax, [rdi + <parameter offset>]; mov [rbp + <slot>], rax
+inline constexpr uint8_t copy_parameter[] = {0x48, 0x8B, 0x87, 0, 0, 0, 0, 0x48, 0x89, 0x85, 0, 0, 0, 0};
+// mov qword [rbp + <slot>], 0
+inline constexpr uint8_t zero_slot[] = {0x48, 0xC7, 0x85, 0, 0, 0, 0, 0, 0, 0, 0};
+// movabs rax, <value>
+inline constexpr uint8_t load_immediate[] = {0x48, 0xB8, 0, 0, 0, 0, 0, 0, 0, 0};
+// mov rax, [rbp + <slot>]
+inline constexpr uint8_t load_slot[] = {0x48, 0x8B, 0x85, 0, 0, 0, 0};
+// movabs rcx, <value>
+inline constexpr uint8_t load_immediate_rhs[] = {0x48, 0xB9, 0, 0, 0, 0, 0, 0, 0, 0};
+// mov rcx, [rbp + <slot>]
+inline constexpr uint8_t load_slot_rhs[] = {0x48, 0x8B, 0x8D, 0, 0, 0, 0};
+// mov [rbp + <slot>], rax
+inline constexpr uint8_t store_slot[] = {0x48, 0x89, 0x85, 0, 0, 0, 0};
+// push rax
+inline constexpr uint8_t push_lhs[] = {0x50};
+// mov rcx, rax; pop rax
+inline constexpr uint8_t pop_lhs[] = {0x48, 0x89, 0xC1, 0x58};
+// add rax, rcx
+inline constexpr uint8_t add[] = {0x48, 0x01, 0xC8};
+// sub rax, rcx
+inline constexpr uint8_t subtract[] = {0x48, 0x29, 0xC8};
+// imul rax, rcx
+inline constexpr uint8_t multiply[] = {0x48, 0x0F, 0xAF, 0xC1};
+// test rcx, rcx; jz <error>; cmp rcx, -1; jne regular; neg rax; jmp done; regular: cqo; idiv rcx; done:
+inline constexpr uint8_t divide[] = {0x48, 0x85, 0xC9, 0x0F, 0x84, 0, 0, 0, 0, 0x48, 0x83, 0xF9, 0xFF, 0x75, 0x05, 0x48, 0xF7, 0xD8, 0xEB, 0x05, 0x48, 0x99, 0x48, 0xF7, 0xF9};
+// neg rax
+inline constexpr uint8_t negate[] = {0x48, 0xF7, 0xD8};
+// mov [rsi], rax; mov eax, 1; leave; ret
+inline constexpr uint8_t return_value[] = {0x48, 0x89, 0x06, 0xB8, 0x01, 0x00, 0x00, 0x00, 0xC9, 0xC3};
+// xor eax, eax; leave; ret
+inline constexpr uint8_t error_exit[] = {0x31, 0xC0, 0xC9, 0xC3};
+} // namespace stencil_code
+
+template <std::size_t size>
+constexpr stencil make_stencil(const uint8_t (&code)[size]) {
+    return {code, size, {}, 0};
+}
+
+template <std::size_t size>
+constexpr stencil make_stencil(const uint8_t (&code)[size], hole first) {
+    return {code, size, {first, hole{}}, 1};
+}
+
+template <std::size_t size>
+constexpr stencil make_stencil(const uint8_t (&code)[size], hole first, hole second) {
+    return {code, size, {first, second}, 2};
+}
+
+namespace stencils {
+inline constexpr stencil prologue = make_stencil(stencil_code::prologue, {7, hole_kind::VALUE32});
+inline constexpr stencil copy_parameter = make_stencil(stencil_code::copy_parameter, {3, hole_kind::VALUE32}, {10, hole_kind::VALUE32});
+inline constexpr stencil zero_slot = make_stencil(stencil_code::zero_slot, {3, hole_kind::VALUE32});
+inline constexpr stencil load_immediate = make_stencil(stencil_code::load_immediate, {2, hole_kind::VALUE64});
+inline constexpr stencil load_slot = make_stencil(stencil_code::load_slot, {3, hole_kind::VALUE32});
+inline constexpr stencil load_immediate_rhs = make_stencil(stencil_code::load_immediate_rhs, {2, hole_kind::VALUE64});
+inline constexpr stencil load_slot_rhs = make_stencil(stencil_code::load_slot_rhs, {3, hole_kind::VALUE32});
+inline constexpr stencil store_slot = make_stencil(stencil_code::store_slot, {3, hole_kind::VALUE32});
+inline constexpr stencil push_lhs = make_stencil(stencil_code::push_lhs);
+inline constexpr stencil pop_lhs = make_stencil(stencil_code::pop_lhs);
+inline constexpr stencil add = make_stencil(stencil_code::add);
+inline constexpr stencil subtract = make_stencil(stencil_code::subtract);
+inline constexpr stencil multiply = make_stencil(stencil_code::multiply);
+inline constexpr stencil divide = make_stencil(stencil_code::divide, {5, hole_kind::ERROR_TARGET});
+inline constexpr stencil negate = make_stencil(stencil_code::negate);
+inline constexpr stencil return_value = make_stencil(stencil_code::return_value);
+inline constexpr stencil error_exit = make_stencil(stencil_code::error_exit);
+} // namespace stencils
+
+} // namespace pljit::codegen::copy_and_patch
+
+#endif //PLJIT_STENCILS_HPP
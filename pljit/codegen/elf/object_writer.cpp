@@ -0,0 +1,101 @@
+#include "object_writer.hpp"
+#include <cstring>
+#include <elf.h>
+
+namespace pljit::codegen::elf {
+
+namespace {
+enum section_index : uint16_t {
+    NULL_SECTION,
+    TEXT,
+    SYMTAB,
+    STRTAB,
+    SHSTRTAB,
+    NOTE_GNU_STACK,
+    NUMBER_OF_SECTIONS
+};
+
+constexpr uint64_t function_alignment = 16;
+
+/// Appends a string to a string table
+uint32_t add_string(std::vector<char>& table, const std::string& string) {
+    const auto offset = static_cast<uint32_t>(table.size());
+    table.insert(table.end(), string.begin(), string.end());
+    table.push_back('\0');
+    return offset;
+}
+
+template <class T>
+uint64_t append(std::vector<uint8_t>& output, const T* data, std::size_t count) {
+    // Sections are 8 byte aligned
+    output.resize((output.size() + 7) / 8 * 8, 0);
+    const uint64_t offset = output.size();
+    const auto* bytes = reinterpret_cast<const uint8_t*>(data);
+    output.insert(output.end(), bytes, bytes + count * sizeof(T));
+    return offset;
+}
+} // namespace
+
+void object_writer::add_function(std::string name, const std::vector<uint8_t>& code) {
+    // Padding between functions traps
+    text.resize((text.size() + function_alignment - 1) / function_alignment * function_alignment, 0xcc);
+    functions.push_back({std::move(name), text.size(), code.size()});
+    text.insert(text.end(), code.begin(), code.end());
+}
+
+std::vector<uint8_t> object_writer::finalize() const {
+    std::vector<char> strtab{'\0'};
+    std::vector<Elf64_Sym> symbols(1);
+    for (const auto& function : functions) {
+        Elf64_Sym symbol{};
+        symbol.st_name = add_string(strtab, function.name);
+        symbol.st_info = ELF64_ST_INFO(STB_GLOBAL, STT_FUNC);
+        symbol.st_other = STV_DEFAULT;
+        symbol.st_shndx = TEXT;
+        symbol.st_value = function.offset;
+        symbol.st_size = function.size;
+        symbols.push_back(symbol);
+    }
+
+    std::vector<char> shstrtab{'\0'};
+    const uint32_t text_name = add_string(shstrtab, ".text");
+    const uint32_t symtab_name = add_string(shstrtab, ".symtab");
+    const uint32_t strtab_name = add_string(shstrtab, ".strtab");
+    const uint32_t shstrtab_name = add_string(shstrtab, ".shstrtab");
+    // Marks the stack as non-executable
+    const uint32_t note_name = add_string(shstrtab, ".note.GNU-stack");
+
+    std::vector<uint8_t> output(sizeof(Elf64_Ehdr), 0);
+    const uint64_t text_offset = append(output, text.data(), text.size());
+    const uint64_t symtab_offset = append(output, symbols.data(), symbols.size());
+    const uint64_t strtab_offset = append(output, strtab.data(), strtab.size());
+    const uint64_t shstrtab_offset = append(output, shstrtab.data(), shstrtab.size());
+
+    Elf64_Shdr sections[NUMBER_OF_SECTIONS]{};
+    sections[TEXT] = {text_name, SHT_PROGBITS, SHF_ALLOC | SHF_EXECINSTR, 0, text_offset, text.size(), 0, 0, function_alignment, 0};
+    // sh_info: index of the first global symbol
+    sections[SYMTAB] = {symtab_name, SHT_SYMTAB, 0, 0, symtab_offset, symbols.size() * sizeof(Elf64_Sym), STRTAB, 1, 8, sizeof(Elf64_Sym)};
+    sections[STRTAB] = {strtab_name, SHT_STRTAB, 0, 0, strtab_offset, strtab.size(), 0, 0, 1, 0};
+    sections[SHSTRTAB] = {shstrtab_name, SHT_STRTAB, 0, 0, shstrtab_offset, shstrtab.size(), 0, 0, 1, 0};
+    sections[NOTE_GNU_STACK] = {note_name, SHT_PROGBITS, 0, 0, shstrtab_offset, 0, 0, 0, 1, 0};
+    const uint64_t section_headers_offset = append(output, sections, NUMBER_OF_SECTIONS);
+
+    Elf64_Ehdr header{};
+    std::memcpy(header.e_ident, ELFMAG, SELFMAG);
+    header.e_ident[EI_CLASS] = ELFCLASS64;
+    header.e_ident[EI_DATA] = ELFDATA2LSB;
+    header.e_ident[EI_VERSION] = EV_CURRENT;
+    header.e_ident[EI_OSABI] = ELFOSABI_SYSV;
+    header.e_type = ET_REL;
+    header.e_machine = EM_X86_64;
+    header.e_version = EV_CURRENT;
+    header.e_shoff = section_headers_offset;
+    header.e_ehsize = sizeof(Elf64_Ehdr);
+    header.e_shentsize = sizeof(Elf64_Shdr);
+    header.e_shnum = NUMBER_OF_SECTIONS;
+    header.e_shstrndx = SHSTRTAB;
+    std::memcpy(output.data(), &header, sizeof(header));
+    return output;
+}
+
+} // namespace pljit::codegen::elf
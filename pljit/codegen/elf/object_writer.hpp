@@ -0,0 +1,34 @@
+#ifndef PLJIT_ELF_OBJECT_WRITER_HPP
+#define PLJIT_ELF_OBJECT_WRITER_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace pljit::codegen::elf {
+
+/**
+ * Packs position-independent x86-64 functions into an ELF64 relocatable object, so they can be linked into
+ * a program or shared library. Every function becomes a global function symbol in .text.
+ */
+class object_writer {
+    struct function {
+        std::string name;
+        uint64_t offset;
+        uint64_t size;
+    };
+
+    std::vector<function> functions;
+    std::vector<uint8_t> text;
+
+    public:
+    /// name has to be a valid, unique symbol name
+    void add_function(std::string name, const std::vector<uint8_t>& code);
+
+    /// @return The contents of the object file
+    std::vector<uint8_t> finalize() const;
+};
+
+} // namespace pljit::codegen::elf
+
+#endif //PLJIT_ELF_OBJECT_WRITER_HPP
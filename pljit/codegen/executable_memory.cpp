@@ -0,0 +1,42 @@
+#include "executable_memory.hpp"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <utility>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace pljit::codegen {
+
+std::optional<executable_memory> executable_memory::allocate(const std::vector<uint8_t>& code) {
+    const auto page_size = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+    const std::size_t size = std::max<std::size_t>(1, (code.size() + page_size - 1) / page_size) * page_size;
+
+    void* memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (memory == MAP_FAILED) {
+        std::cerr << "Error: Could not map memory for generated code" << std::endl;
+        return std::nullopt;
+    }
+    std::memcpy(memory, code.data(), code.size());
+    if (mprotect(memory, size, PROT_READ | PROT_EXEC) != 0) {
+        std::cerr << "Error: Could not make generated code executable" << std::endl;
+        munmap(memory, size);
+        return std::nullopt;
+    }
+    return executable_memory(memory, size);
+}
+
+executable_memory::executable_memory(executable_memory&& other) noexcept
+    : memory(std::exchange(other.memory, nullptr)), mapped_size(std::exchange(other.mapped_size, 0)) {}
+
+executable_memory& executable_memory::operator=(executable_memory&& other) noexcept {
+    std::swap(memory, other.memory);
+    std::swap(mapped_size, other.mapped_size);
+    return *this;
+}
+
+executable_memory::~executable_memory() {
+    if (memory) munmap(memory, mapped_size);
+}
+
+} // namespace pljit::codegen
@@ -0,0 +1,42 @@
+#ifndef PLJIT_EXECUTABLE_MEMORY_HPP
+#define PLJIT_EXECUTABLE_MEMORY_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace pljit::codegen {
+
+/**
+ * Owns a mapping of pages holding machine code. The pages are never writable and executable at
+ * the same time: the code is copied into a writable mapping which is then turned read-only and executable.
+ */
+class executable_memory {
+    void* memory = nullptr;
+    std::size_t mapped_size = 0;
+
+    executable_memory(void* memory, std::size_t mapped_size) : memory(memory), mapped_size(mapped_size) {}
+
+    public:
+    /// @return The mapped code or std::nullopt if the pages could not be allocated
+    static std::optional<executable_memory> allocate(const std::vector<uint8_t>& code);
+
+    executable_memory(const executable_memory&) = delete;
+    executable_memory& operator=(const executable_memory&) = delete;
+    executable_memory(executable_memory&& other) noexcept;
+    executable_memory& operator=(executable_memory&& other) noexcept;
+    ~executable_memory();
+
+    const void* get() const {
+        return memory;
+    }
+
+    std::size_t size() const {
+        return mapped_size;
+    }
+};
+
+} // namespace pljit::codegen
+
+#endif //PLJIT_EXECUTABLE_MEMORY_HPP
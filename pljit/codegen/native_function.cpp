@@ -0,0 +1,20 @@
+#include "native_function.hpp"
+#include "pljit/execution/arithmetic.hpp"
+#include <utility>
+
+namespace pljit::codegen {
+
+native_function::native_function(executable_memory code)
+    : code(std::move(code)), entry(reinterpret_cast<entry_point>(const_cast<void*>(this->code.get()))) {}
+
+std::optional<int64_t> native_function::execute_impl(const int64_t* parameters, int64_t*) const {
+    int64_t result;
+    if (!entry(parameters, &result)) {
+        // Division by zero is the only way generated code fails
+        execution::report_division_by_zero();
+        return std::nullopt;
+    }
+    return result;
+}
+
+} // namespace pljit::codegen
@@ -0,0 +1,40 @@
+#ifndef PLJIT_NATIVE_FUNCTION_HPP
+#define PLJIT_NATIVE_FUNCTION_HPP
+
+#include "pljit/codegen/executable_memory.hpp"
+#include "pljit/execution/compiled_function.hpp"
+
+namespace pljit::codegen {
+
+/**
+ * Machine code generated for a function. The code follows the System V calling convention with the signature
+ *      bool entry(const int64_t* parameters, int64_t* result)
+ * and returns false if execution failed.
+ */
+class native_function : public execution::compiled_function {
+    public:
+    using entry_point = bool (*)(const int64_t* parameters, int64_t* result);
+
+    private:
+    executable_memory code;
+    entry_point entry;
+
+    protected:
+    std::optional<int64_t> execute_impl(const int64_t* parameters, int64_t* frame) const override;
+
+    public:
+    explicit native_function(executable_memory code);
+
+    /// The generated code keeps its frame on the machine stack
+    std::size_t get_frame_size() const override {
+        return 0;
+    }
+
+    entry_point get_entry_point() const {
+        return entry;
+    }
+};
+
+} // namespace pljit::codegen
+
+#endif //PLJIT_NATIVE_FUNCTION_HPP
@@ -0,0 +1,230 @@
+#include "assembler.hpp"
+#include <cassert>
+#include <cstring>
+#include <limits>
+#include <utility>
+
+namespace pljit::codegen::x86_64 {
+
+namespace {
+uint8_t low_bits(reg r) {
+    return static_cast<uint8_t>(r) & 0x7;
+}
+bool is_extended(reg r) {
+    return static_cast<uint8_t>(r) >= 8;
+}
+} // namespace
+
+void assembler::emit_byte(uint8_t byte) {
+    code.push_back(byte);
+}
+
+void assembler::emit_int32(int32_t value) {
+    uint8_t bytes[sizeof(value)];
+    std::memcpy(bytes, &value, sizeof(value));
+    code.insert(code.end(), std::begin(bytes), std::end(bytes));
+}
+
+void assembler::emit_int64(int64_t value) {
+    uint8_t bytes[sizeof(value)];
+    std::memcpy(bytes, &value, sizeof(value));
+    code.insert(code.end(), std::begin(bytes), std::end(bytes));
+}
+
+void assembler::emit_rex_w(reg modrm_reg, reg modrm_rm) {
+    emit_byte(0x48 | (is_extended(modrm_reg) ? 0x4 : 0) | (is_extended(modrm_rm) ? 0x1 : 0));
+}
+
+void assembler::emit_modrm_register(reg modrm_reg, reg modrm_rm) {
+    emit_byte(0xC0 | low_bits(modrm_reg) << 3 | low_bits(modrm_rm));
+}
+
+void assembler::emit_modrm_memory(reg modrm_reg, reg base, int32_t displacement) {
+    // mod = 10: [base + disp32]
+    emit_byte(0x80 | low_bits(modrm_reg) << 3 | low_bits(base));
+    if (low_bits(base) == low_bits(reg::RSP)) {
+        // rsp/r12 as base require a SIB byte
+        emit_byte(0x24);
+    }
+    emit_int32(displacement);
+}
+
+void assembler::emit_rel32(label_id target) {
+    assert(target < labels.size());
+    labels[target].fixups.push_back(code.size());
+    emit_int32(0);
+}
+
+void assembler::emit_shift(uint8_t extension, reg destination, uint8_t count) {
+    assert(count < 64);
+    emit_rex_w(reg::RAX, destination);
+    emit_byte(0xC1);
+    emit_modrm_register(static_cast<reg>(extension), destination);
+    emit_byte(count);
+}
+
+auto assembler::create_label() -> label_id {
+    labels.emplace_back();
+    return labels.size() - 1;
+}
+
+void assembler::bind(label_id label) {
+    assert(label < labels.size() && !labels[label].position);
+    labels[label].position = code.size();
+}
+
+void assembler::push(reg source) {
+    if (is_extended(source)) emit_byte(0x41);
+    emit_byte(0x50 | low_bits(source));
+}
+
+void assembler::pop(reg destination) {
+    if (is_extended(destination)) emit_byte(0x41);
+    emit_byte(0x58 | low_bits(destination));
+}
+
+void assembler::mov(reg destination, reg source) {
+    emit_rex_w(source, destination);
+    emit_byte(0x89);
+    emit_modrm_register(source, destination);
+}
+
+void assembler::mov(reg destination, int64_t immediate) {
+    if (immediate >= std::numeric_limits<int32_t>::min() && immediate <= std::numeric_limits<int32_t>::max()) {
+        // mov r/m64, imm32 (sign extended)
+        emit_rex_w(reg::RAX, destination);
+        emit_byte(0xC7);
+        emit_modrm_register(reg::RAX, destination);
+        emit_int32(static_cast<int32_t>(immediate));
+    } else {
+        // movabs r64, imm64
+        emit_rex_w(reg::RAX, destination);
+        emit_byte(0xB8 | low_bits(destination));
+        emit_int64(immediate);
+    }
+}
+
+void assembler::load(reg destination, reg base, int32_t displacement) {
+    emit_rex_w(destination, base);
+    emit_byte(0x8B);
+    emit_modrm_memory(destination, base, displacement);
+}
+
+void assembler::store(reg base, int32_t displacement, reg source) {
+    emit_rex_w(source, base);
+    emit_byte(0x89);
+    emit_modrm_memory(source, base, displacement);
+}
+
+void assembler::add(reg destination, reg source) {
+    emit_rex_w(source, destination);
+    emit_byte(0x01);
+    emit_modrm_register(source, destination);
+}
+
+void assembler::sub(reg destination, reg source) {
+    emit_rex_w(source, destination);
+    emit_byte(0x29);
+    emit_modrm_register(source, destination);
+}
+
+void assembler::sub(reg destination, int32_t immediate) {
+    emit_rex_w(reg::RAX, destination);
+    emit_byte(0x81);
+    emit_modrm_register(static_cast<reg>(5), destination);
+    emit_int32(immediate);
+}
+
+void assembler::imul(reg destination, reg source) {
+    emit_rex_w(destination, source);
+    emit_byte(0x0F);
+    emit_byte(0xAF);
+    emit_modrm_register(destination, source);
+}
+
+void assembler::imul(reg source) {
+    emit_rex_w(reg::RAX, source);
+    emit_byte(0xF7);
+    emit_modrm_register(static_cast<reg>(5), source);
+}
+
+void assembler::neg(reg destination) {
+    emit_rex_w(reg::RAX, destination);
+    emit_byte(0xF7);
+    emit_modrm_register(static_cast<reg>(3), destination);
+}
+
+void assembler::shl(reg destination, uint8_t count) {
+    emit_shift(4, destination, count);
+}
+
+void assembler::sar(reg destination, uint8_t count) {
+    emit_shift(7, destination, count);
+}
+
+void assembler::shr(reg destination, uint8_t count) {
+    emit_shift(5, destination, count);
+}
+
+void assembler::cqo() {
+    emit_byte(0x48);
+    emit_byte(0x99);
+}
+
+void assembler::idiv(reg divisor) {
+    emit_rex_w(reg::RAX, divisor);
+    emit_byte(0xF7);
+    emit_modrm_register(static_cast<reg>(7), divisor);
+}
+
+void assembler::test(reg lhs, reg rhs) {
+    emit_rex_w(rhs, lhs);
+    emit_byte(0x85);
+    emit_modrm_register(rhs, lhs);
+}
+
+void assembler::cmp(reg lhs, int8_t immediate) {
+    emit_rex_w(reg::RAX, lhs);
+    emit_byte(0x83);
+    emit_modrm_register(static_cast<reg>(7), lhs);
+    emit_byte(static_cast<uint8_t>(immediate));
+}
+
+void assembler::xor_(reg destination, reg source) {
+    emit_rex_w(source, destination);
+    emit_byte(0x31);
+    emit_modrm_register(source, destination);
+}
+
+void assembler::jmp(label_id target) {
+    emit_byte(0xE9);
+    emit_rel32(target);
+}
+
+void assembler::jcc(condition cond, label_id target) {
+    emit_byte(0x0F);
+    emit_byte(0x80 | static_cast<uint8_t>(cond));
+    emit_rel32(target);
+}
+
+void assembler::leave() {
+    emit_byte(0xC9);
+}
+
+void assembler::ret() {
+    emit_byte(0xC3);
+}
+
+std::vector<uint8_t> assembler::finalize() {
+    for (const auto& label : labels) {
+        assert(label.position || label.fixups.empty());
+        for (auto fixup : label.fixups) {
+            // Relative to the end of the rel32 field
+            auto displacement = static_cast<int32_t>(static_cast<int64_t>(*label.position) - static_cast<int64_t>(fixup + sizeof(int32_t)));
+            std::memcpy(&code[fixup], &displacement, sizeof(displacement));
+        }
+    }
+    return std::move(code);
+}
+
+} // namespace pljit::codegen::x86_64
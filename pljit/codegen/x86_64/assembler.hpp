@@ -0,0 +1,114 @@
+#ifndef PLJIT_X86_64_ASSEMBLER_HPP
+#define PLJIT_X86_64_ASSEMBLER_HPP
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace pljit::codegen::x86_64 {
+
+/// General purpose registers, numbered as in the instruction encoding
+enum class reg : uint8_t {
+    RAX,
+    RCX,
+    RDX,
+    RBX,
+    RSP,
+    RBP,
+    RSI,
+    RDI,
+    R8,
+    R9,
+    R10,
+    R11,
+    R12,
+    R13,
+    R14,
+    R15
+};
+
+/// Condition codes for conditional jumps
+enum class condition : uint8_t {
+    EQUAL = 0x4,
+    NOT_EQUAL = 0x5
+};
+
+/**
+ * Minimal x86-64 encoder for the instructions the code generator needs. All operations work
+ * on 64 bit operands. Memory operands are always [base + disp32].
+ */
+class assembler {
+    public:
+    using label_id = std::size_t;
+
+    private:
+    struct label {
+        std::optional<std::size_t> position;
+        /// Offsets of rel32 fields that refer to this label
+        std::vector<std::size_t> fixups;
+    };
+
+    std::vector<uint8_t> code;
+    std::vector<label> labels;
+
+    void emit_byte(uint8_t byte);
+    void emit_int32(int32_t value);
+    void emit_int64(int64_t value);
+    void emit_rex_w(reg modrm_reg, reg modrm_rm);
+    void emit_modrm_register(reg modrm_reg, reg modrm_rm);
+    void emit_modrm_memory(reg modrm_reg, reg base, int32_t displacement);
+    void emit_rel32(label_id target);
+    void emit_shift(uint8_t extension, reg destination, uint8_t count);
+
+    public:
+    label_id create_label();
+    /// Binds the label to the current position
+    void bind(label_id label);
+
+    void push(reg source);
+    void pop(reg destination);
+    /// mov destination, source
+    void mov(reg destination, reg source);
+    /// mov destination, immediate - uses the shortest encoding for the immediate
+    void mov(reg destination, int64_t immediate);
+    /// mov destination, [base + displacement]
+    void load(reg destination, reg base, int32_t displacement);
+    /// mov [base + displacement], source
+    void store(reg base, int32_t displacement, reg source);
+
+    void add(reg destination, reg source);
+    void sub(reg destination, reg source);
+    void sub(reg destination, int32_t immediate);
+    void imul(reg destination, reg source);
+    /// Multiplies rax by source, the signed 128 bit product is stored in rdx:rax
+    void imul(reg source);
+    void neg(reg destination);
+    void shl(reg destination, uint8_t count);
+    /// Arithmetic shift right
+    void sar(reg destination, uint8_t count);
+    /// Logical shift right
+    void shr(reg destination, uint8_t count);
+    /// Sign extends rax into rdx:rax
+    void cqo();
+    /// Divides rdx:rax by divisor, quotient in rax, remainder in rdx
+    void idiv(reg divisor);
+    void test(reg lhs, reg rhs);
+    void cmp(reg lhs, int8_t immediate);
+    void xor_(reg destination, reg source);
+
+    void jmp(label_id target);
+    void jcc(condition cond, label_id target);
+    void leave();
+    void ret();
+
+    std::size_t size() const {
+        return code.size();
+    }
+
+    /// Resolves all jumps and returns the machine code. Every referenced label has to be bound.
+    std::vector<uint8_t> finalize();
+};
+
+} // namespace pljit::codegen::x86_64
+
+#endif //PLJIT_X86_64_ASSEMBLER_HPP
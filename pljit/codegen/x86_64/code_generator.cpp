@@ -0,0 +1,280 @@
+#include "code_generator.hpp"
+#include "pljit/codegen/native_function.hpp"
+#include "pljit/semantic_analysis/AST.hpp"
+
+using namespace pljit::semantic_analysis;
+
+namespace pljit::codegen::x86_64 {
+
+namespace {
+/// Magnitude of a value, also for the most negative one
+uint64_t magnitude(int64_t value) {
+    return value < 0 ? 0 - static_cast<uint64_t>(value) : static_cast<uint64_t>(value);
+}
+
+/// Exponent k if value is 2^k, k > 0
+std::optional<uint8_t> power_of_two(uint64_t value) {
+    if (value < 2 || (value & (value - 1)) != 0) return std::nullopt;
+    uint8_t exponent = 0;
+    while (value >>= 1) ++exponent;
+    return exponent;
+}
+
+struct division_magic {
+    int64_t multiplier;
+    uint8_t shift;
+};
+
+/// Reciprocal for signed division by divisor, |divisor| >= 2 and no power of two (Hacker's Delight, figure 10-1)
+division_magic magic_for(int64_t divisor) {
+    constexpr uint64_t two63 = uint64_t{1} << 63;
+    const uint64_t ad = magnitude(divisor);
+    const uint64_t t = two63 + (static_cast<uint64_t>(divisor) >> 63);
+    const uint64_t anc = t - 1 - t % ad;
+    unsigned p = 63;
+    uint64_t q1 = two63 / anc;
+    uint64_t r1 = two63 - q1 * anc;
+    uint64_t q2 = two63 / ad;
+    uint64_t r2 = two63 - q2 * ad;
+    uint64_t delta;
+    do {
+        ++p;
+        q1 *= 2;
+        r1 *= 2;
+        if (r1 >= anc) {
+            ++q1;
+            r1 -= anc;
+        }
+        q2 *= 2;
+        r2 *= 2;
+        if (r2 >= ad) {
+            ++q2;
+            r2 -= ad;
+        }
+        delta = ad - r2;
+    } while (q1 < delta || (q1 == delta && r1 == 0));
+    const uint64_t multiplier = q2 + 1;
+    return {static_cast<int64_t>(divisor < 0 ? 0 - multiplier : multiplier), static_cast<uint8_t>(p - 64)};
+}
+} // namespace
+
+code_generator::code_generator(assembler& as, const symbol_table& symbols) : as(as), symbols(symbols), error_label(as.create_label()) {}
+
+int32_t code_generator::frame_offset(symbol_table::symbol_handle symbol) {
+    return -8 * static_cast<int32_t>(symbol + 1);
+}
+
+bool code_generator::is_leaf(const ExpressionNode& node) {
+    return node.getType() == ASTNode::Literal || node.getType() == ASTNode::Identifier;
+}
+
+void code_generator::evaluate_into(ExpressionNode& node, reg destination) {
+    target = destination;
+    node.accept(*this);
+    target = reg::RAX;
+}
+
+std::optional<int64_t> code_generator::constant_value(const ExpressionNode& node) const {
+    if (node.getType() == ASTNode::Literal) return static_cast<const LiteralNode&>(node).get_value();
+    if (node.getType() == ASTNode::Identifier) {
+        const auto& symbol = symbols.get(static_cast<const IdentifierNode&>(node).get_symbol_handle());
+        if (symbol.type == symbol::CONSTANT) return symbol.get_value();
+    }
+    return std::nullopt;
+}
+
+bool code_generator::multiply_by_constant(ExpressionNode& operand, int64_t factor) {
+    const auto exponent = power_of_two(magnitude(factor));
+    if (!exponent && factor != 0 && factor != 1 && factor != -1) return false;
+    // The operand is still evaluated, it might divide by zero
+    evaluate_into(operand, reg::RAX);
+    if (factor == 0) {
+        as.xor_(reg::RAX, reg::RAX);
+        return true;
+    }
+    // Wraps around exactly like imul
+    if (exponent) as.shl(reg::RAX, *exponent);
+    if (factor < 0) as.neg(reg::RAX);
+    return true;
+}
+
+bool code_generator::divide_by_constant(ExpressionNode& operand, int64_t divisor) {
+    if (divisor == 0) return false;
+    evaluate_into(operand, reg::RAX);
+    if (divisor == 1 || divisor == -1) {
+        // INT64_MIN / -1 wraps around like in the general case
+        if (divisor == -1) as.neg(reg::RAX);
+        return true;
+    }
+    if (const auto exponent = power_of_two(magnitude(divisor))) {
+        // Negative dividends are biased by 2^k - 1 to round towards zero
+        as.mov(reg::RCX, reg::RAX);
+        as.sar(reg::RCX, 63);
+        as.shr(reg::RCX, static_cast<uint8_t>(64 - *exponent));
+        as.add(reg::RAX, reg::RCX);
+        as.sar(reg::RAX, *exponent);
+        if (divisor < 0) as.neg(reg::RAX);
+        return true;
+    }
+
+    const auto magic = magic_for(divisor);
+    as.mov(reg::RCX, reg::RAX);
+    as.mov(reg::RDX, magic.multiplier);
+    as.imul(reg::RDX);
+    // rdx holds the high half of the product, correct it where the multiplier's sign is off
+    if (divisor > 0 && magic.multiplier < 0) as.add(reg::RDX, reg::RCX);
+    if (divisor < 0 && magic.multiplier > 0) as.sub(reg::RDX, reg::RCX);
+    if (magic.shift > 0) as.sar(reg::RDX, magic.shift);
+    // Add one for negative quotients to round towards zero
+    as.mov(reg::RAX, reg::RDX);
+    as.shr(reg::RAX, 63);
+    as.add(reg::RAX, reg::RDX);
+    return true;
+}
+
+void code_generator::visit(FunctionNode& node) {
+    // Prologue - one 8 byte slot per symbol, keeping rsp 16 byte aligned
+    const auto frame_size = static_cast<int32_t>((symbols.size() * 8 + 15) & ~std::size_t{15});
+    as.push(reg::RBP);
+    as.mov(reg::RBP, reg::RSP);
+    if (frame_size > 0) as.sub(reg::RSP, frame_size);
+
+    // Parameters are passed in rdi and may be reassigned, so copy them into the frame
+    for (symbol_table::size_type i = 0; i < symbols.get_number_of_parameters(); ++i) {
+        as.load(reg::RAX, reg::RDI, static_cast<int32_t>(i * 8));
+        as.store(reg::RBP, frame_offset(i), reg::RAX);
+    }
+    // Variables start out as 0, x := x + 1 may read one before its first assignment
+    const auto first_variable = symbols.get_number_of_parameters();
+    const auto end_of_variables = first_variable + symbols.get_number_of_variables();
+    if (end_of_variables > first_variable) as.xor_(reg::RAX, reg::RAX);
+    for (auto i = first_variable; i < end_of_variables; ++i) {
+        as.store(reg::RBP, frame_offset(i), reg::RAX);
+    }
+
+    for (unsigned i = 0; i < node.get_number_of_statements(); ++i) {
+        node.get_statement(i)->accept(*this);
+        // Anything after the first return is unreachable
+        if (node.get_statement(i)->getType() == ASTNode::ReturnStatement) break;
+    }
+
+    as.bind(error_label);
+    as.xor_(reg::RAX, reg::RAX);
+    as.leave();
+    as.ret();
+}
+
+void code_generator::visit(IdentifierNode& node) {
+    const auto& symbol = symbols.get(node.get_symbol_handle());
+    if (symbol.type == symbol::CONSTANT) {
+        as.mov(target, symbol.get_value());
+    } else {
+        as.load(target, reg::RBP, frame_offset(node.get_symbol_handle()));
+    }
+}
+
+void code_generator::visit(LiteralNode& node) {
+    as.mov(target, node.get_value());
+}
+
+void code_generator::visit(ReturnStatementNode& node) {
+    evaluate_into(node.get_expression(), reg::RAX);
+    // The result pointer is passed in rsi, which is never clobbered
+    as.store(reg::RSI, 0, reg::RAX);
+    as.mov(reg::RAX, int64_t{1});
+    as.leave();
+    as.ret();
+}
+
+void code_generator::visit(AssignmentNode& node) {
+    evaluate_into(node.get_expression(), reg::RAX);
+    as.store(reg::RBP, frame_offset(node.get_identifier().get_symbol_handle()), reg::RAX);
+}
+
+void code_generator::visit(UnaryOperatorASTNode& node) {
+    const reg destination = target;
+    evaluate_into(node.getInput(), destination);
+    if (node.get_operator() == UnaryOperatorASTNode::OperatorType::MINUS) {
+        as.neg(destination);
+    }
+}
+
+void code_generator::visit(BinaryOperatorASTNode& node) {
+    const reg destination = target;
+    if (node.get_operator() == BinaryOperatorASTNode::OperatorType::MULTIPLY) {
+        const auto right = constant_value(node.getRight());
+        const auto left = constant_value(node.getLeft());
+        if ((right && multiply_by_constant(node.getLeft(), *right)) || (!right && left && multiply_by_constant(node.getRight(), *left))) {
+            if (destination != reg::RAX) as.mov(destination, reg::RAX);
+            return;
+        }
+    } else if (node.get_operator() == BinaryOperatorASTNode::OperatorType::DIVIDE) {
+        const auto divisor = constant_value(node.getRight());
+        if (divisor && divide_by_constant(node.getLeft(), *divisor)) {
+            if (destination != reg::RAX) as.mov(destination, reg::RAX);
+            return;
+        }
+    }
+
+    evaluate_into(node.getLeft(), reg::RAX);
+    if (is_leaf(node.getRight())) {
+        evaluate_into(node.getRight(), reg::RCX);
+    } else {
+        as.push(reg::RAX);
+        evaluate_into(node.getRight(), reg::RAX);
+        as.mov(reg::RCX, reg::RAX);
+        as.pop(reg::RAX);
+    }
+
+    switch (node.get_operator()) {
+        case BinaryOperatorASTNode::OperatorType::PLUS: {
+            as.add(reg::RAX, reg::RCX);
+            break;
+        }
+        case BinaryOperatorASTNode::OperatorType::MINUS: {
+            as.sub(reg::RAX, reg::RCX);
+            break;
+        }
+        case BinaryOperatorASTNode::OperatorType::MULTIPLY: {
+            as.imul(reg::RAX, reg::RCX);
+            break;
+        }
+        case BinaryOperatorASTNode::OperatorType::DIVIDE: {
+            auto regular_division = as.create_label();
+            auto done = as.create_label();
+            as.test(reg::RCX, reg::RCX);
+            as.jcc(condition::EQUAL, error_label);
+            // idiv traps on INT64_MIN / -1, negate instead (wraps around)
+            as.cmp(reg::RCX, -1);
+            as.jcc(condition::NOT_EQUAL, regular_division);
+            as.neg(reg::RAX);
+            as.jmp(done);
+            as.bind(regular_division);
+            as.cqo();
+            as.idiv(reg::RCX);
+            as.bind(done);
+            break;
+        }
+    }
+    if (destination != reg::RAX) as.mov(destination, reg::RAX);
+}
+
+std::vector<uint8_t> code_generator::generate(FunctionNode& function) {
+    assembler as;
+    code_generator generator(as, function.getSymbolTable());
+    function.accept(generator);
+    return as.finalize();
+}
+
+std::unique_ptr<execution::compiled_function> code_generator::compile(FunctionNode& function) {
+#if defined(__x86_64__) && defined(__unix__)
+    auto memory = executable_memory::allocate(generate(function));
+    if (!memory) return nullptr;
+    return std::make_unique<native_function>(std::move(*memory));
+#else
+    (void) function;
+    return nullptr;
+#endif
+}
+
+} // namespace pljit::codegen::x86_64
@@ -0,0 +1,65 @@
+#ifndef PLJIT_X86_64_CODE_GENERATOR_HPP
+#define PLJIT_X86_64_CODE_GENERATOR_HPP
+
+#include "pljit/codegen/x86_64/assembler.hpp"
+#include "pljit/execution/compiled_function.hpp"
+#include "pljit/semantic_analysis/ast_visitor.hpp"
+#include "pljit/semantic_analysis/symbol_table.hpp"
+#include <memory>
+#include <optional>
+
+namespace pljit::codegen::x86_64 {
+
+/**
+ * Lowers an AST to x86-64 machine code.
+ *
+ * Every parameter and variable lives in a slot of the stack frame, constants are encoded as immediates.
+ * Expressions are evaluated into rax, rcx holds the right hand side of binary operations and intermediate
+ * results are spilled onto the stack.
+ *
+ * Multiplications by powers of two become shifts, divisions by constants a multiplication with a
+ * precomputed reciprocal (see Hacker's Delight, chapter 10), so idiv is only used for unknown divisors.
+ */
+class code_generator : public semantic_analysis::ast_visitor {
+    assembler& as;
+    const semantic_analysis::symbol_table& symbols;
+    assembler::label_id error_label;
+    /// Register the currently visited expression is evaluated into
+    reg target = reg::RAX;
+
+    code_generator(assembler& as, const semantic_analysis::symbol_table& symbols);
+
+    static int32_t frame_offset(semantic_analysis::symbol_table::symbol_handle symbol);
+    /// Whether node can be loaded into any register without clobbering rax
+    static bool is_leaf(const semantic_analysis::ExpressionNode& node);
+    void evaluate_into(semantic_analysis::ExpressionNode& node, reg destination);
+    /// Value of a literal or constant operand
+    std::optional<int64_t> constant_value(const semantic_analysis::ExpressionNode& node) const;
+    /// Computes operand * factor into rax without imul, @return false if that is not cheaper
+    bool multiply_by_constant(semantic_analysis::ExpressionNode& operand, int64_t factor);
+    /// Computes operand / divisor into rax without idiv, @return false for a zero divisor
+    bool divide_by_constant(semantic_analysis::ExpressionNode& operand, int64_t divisor);
+
+    public:
+    void visit(semantic_analysis::FunctionNode& node) override;
+    void visit(semantic_analysis::IdentifierNode& node) override;
+    void visit(semantic_analysis::LiteralNode& node) override;
+    void visit(semantic_analysis::ReturnStatementNode& node) override;
+    void visit(semantic_analysis::AssignmentNode& node) override;
+    void visit(semantic_analysis::UnaryOperatorASTNode& node) override;
+    void visit(semantic_analysis::BinaryOperatorASTNode& node) override;
+
+    /**
+     * Position-independent machine code of the function, callable as
+     *      bool entry(const int64_t* parameters, int64_t* result)
+     * Works on every host, e.g. to compile ahead of time.
+     */
+    static std::vector<uint8_t> generate(semantic_analysis::FunctionNode& function);
+
+    /// @return The machine code of the function or nullptr if native code cannot be generated on this platform
+    static std::unique_ptr<execution::compiled_function> compile(semantic_analysis::FunctionNode& function);
+};
+
+} // namespace pljit::codegen::x86_64
+
+#endif //PLJIT_X86_64_CODE_GENERATOR_HPP
@@ -0,0 +1,35 @@
+#include "compilation_cache.hpp"
+
+namespace pljit {
+
+std::string compilation_cache::normalize(std::string_view source) {
+    auto is_whitespace = [](char c) { return c == ' ' || c == '\t' || c == '\n'; };
+    std::string normalized;
+    normalized.reserve(source.size());
+    bool pending_whitespace = false;
+    for (char c : source) {
+        if (is_whitespace(c)) {
+            pending_whitespace = true;
+            continue;
+        }
+        // A single blank keeps adjacent tokens apart
+        if (pending_whitespace && !normalized.empty()) normalized.push_back(' ');
+        pending_whitespace = false;
+        normalized.push_back(c);
+    }
+    return normalized;
+}
+
+compilation_cache::entry compilation_cache::get_or_create(std::string key, const std::function<entry()>& create) {
+    auto& shard = shards[std::hash<std::string>{}(key) % number_of_shards];
+    std::unique_lock lock{shard.mutex};
+    if (auto iter = shard.entries.find(key); iter != shard.entries.end()) {
+        return iter->second;
+    }
+    // Creating under the lock keeps concurrent registrations of the same source from compiling twice
+    auto created = create();
+    shard.entries.emplace(std::move(key), created);
+    return created;
+}
+
+} // namespace pljit
@@ -0,0 +1,51 @@
+#ifndef PLJIT_COMPILATION_CACHE_HPP
+#define PLJIT_COMPILATION_CACHE_HPP
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace pljit {
+
+class Function;
+
+/**
+ * Maps normalized source code to the function compiled from it, so identical sources registered many times
+ * share one Function (source, AST, symbol table and generated code). Sharded to keep concurrent
+ * registrations from contending on one lock.
+ */
+class compilation_cache {
+    public:
+    struct entry {
+        uint32_t id;
+        Function* function;
+    };
+
+    private:
+    static constexpr unsigned number_of_shards = 16;
+
+    struct shard {
+        std::mutex mutex;
+        std::unordered_map<std::string, entry> entries;
+    };
+    std::array<shard, number_of_shards> shards;
+
+    public:
+    /// Collapses whitespace the lexer ignores, so formatting differences do not prevent sharing
+    static std::string normalize(std::string_view source);
+
+    /**
+     * @param key Normalized source, plus anything else that influences compilation
+     * @param create Registers a new function, only called if key is not cached yet
+     * @return The cached or newly created entry
+     */
+    entry get_or_create(std::string key, const std::function<entry()>& create);
+};
+
+} // namespace pljit
+
+#endif //PLJIT_COMPILATION_CACHE_HPP
@@ -0,0 +1,135 @@
+#include "compile_statistics.hpp"
+#include "pljit/parser/parse_tree_nodes.hpp"
+#include "pljit/parser/parse_tree_visitor.hpp"
+#include "pljit/semantic_analysis/AST.hpp"
+#include "pljit/semantic_analysis/ast_visitor.hpp"
+#include <algorithm>
+#include <iomanip>
+#include <ostream>
+
+namespace pljit {
+
+namespace {
+
+class parse_tree_counter : public parser::parse_tree_visitor {
+    template <class node_type>
+    void count_non_terminal(const node_type& node) {
+        ++non_terminals;
+        for (const auto& child : node.get_children()) {
+            child->accept(*this);
+        }
+    }
+
+    public:
+    std::size_t terminals = 0;
+    std::size_t non_terminals = 0;
+
+    void visit(const parser::declarator_list_node& node) override { count_non_terminal(node); }
+    void visit(const parser::identifier_node& node) override { count_non_terminal(node); }
+    void visit(const parser::literal_node& node) override { count_non_terminal(node); }
+    void visit(const parser::terminal_node&) override { ++terminals; }
+    void visit(const parser::additive_expression_node& node) override { count_non_terminal(node); }
+    void visit(const parser::assignment_expression_node& node) override { count_non_terminal(node); }
+    void visit(const parser::compound_statement_node& node) override { count_non_terminal(node); }
+    void visit(const parser::constant_declaration_node& node) override { count_non_terminal(node); }
+    void visit(const parser::init_declarator_list_node& node) override { count_non_terminal(node); }
+    void visit(const parser::init_declarator_node& node) override { count_non_terminal(node); }
+    void visit(const parser::multiplicative_expression_node& node) override { count_non_terminal(node); }
+    void visit(const parser::parameter_declaration_node& node) override { count_non_terminal(node); }
+    void visit(const parser::primary_expression_node& node) override { count_non_terminal(node); }
+    void visit(const parser::statement_list_node& node) override { count_non_terminal(node); }
+    void visit(const parser::statement_node& node) override { count_non_terminal(node); }
+    void visit(const parser::function_definition_node& node) override { count_non_terminal(node); }
+    void visit(const parser::unary_expression_node& node) override { count_non_terminal(node); }
+    void visit(const parser::variable_declaration_node& node) override { count_non_terminal(node); }
+};
+
+class ast_counter : public semantic_analysis::ast_visitor {
+    public:
+    std::size_t nodes = 0;
+
+    void visit(semantic_analysis::FunctionNode& node) override {
+        ++nodes;
+        for (unsigned i = 0; i < node.get_number_of_statements(); ++i) {
+            node.get_statement(i)->accept(*this);
+        }
+    }
+    void visit(semantic_analysis::IdentifierNode&) override { ++nodes; }
+    void visit(semantic_analysis::LiteralNode&) override { ++nodes; }
+    void visit(semantic_analysis::ReturnStatementNode& node) override {
+        ++nodes;
+        node.get_expression().accept(*this);
+    }
+    void visit(semantic_analysis::AssignmentNode& node) override {
+        ++nodes;
+        node.get_identifier().accept(*this);
+        node.get_expression().accept(*this);
+    }
+    void visit(semantic_analysis::UnaryOperatorASTNode& node) override {
+        ++nodes;
+        node.getInput().accept(*this);
+    }
+    void visit(semantic_analysis::BinaryOperatorASTNode& node) override {
+        ++nodes;
+        node.getLeft().accept(*this);
+        node.getRight().accept(*this);
+    }
+};
+
+} // namespace
+
+void compile_statistics::count(const parser::function_definition_node& parse_tree) {
+    parse_tree_counter counter;
+    parse_tree.accept(counter);
+    tokens += counter.terminals;
+    parse_tree_nodes += counter.non_terminals;
+}
+
+void compile_statistics::count(semantic_analysis::FunctionNode& ast) {
+    ast_counter counter;
+    ast.accept(counter);
+    ast_nodes += counter.nodes;
+    symbols += ast.getSymbolTable().size();
+}
+
+std::chrono::nanoseconds compile_statistics::total_time() const {
+    std::chrono::nanoseconds total{0};
+    for (auto time : phase_times) total += time;
+    return total;
+}
+
+compile_statistics& compile_statistics::operator+=(const compile_statistics& other) {
+    compilations += other.compilations;
+    for (unsigned i = 0; i < NUMBER_OF_PHASES; ++i) phase_times[i] += other.phase_times[i];
+    bytes_lexed += other.bytes_lexed;
+    tokens += other.tokens;
+    parse_tree_nodes += other.parse_tree_nodes;
+    ast_nodes += other.ast_nodes;
+    symbols += other.symbols;
+    for (const auto& pass : other.passes) {
+        auto match = std::find_if(passes.begin(), passes.end(), [&](const auto& candidate) { return candidate.name == pass.name; });
+        if (match == passes.end()) {
+            passes.push_back(pass);
+            continue;
+        }
+        match->runs += pass.runs;
+        match->nodes_folded += pass.nodes_folded;
+        match->statements_removed += pass.statements_removed;
+        match->time += pass.time;
+    }
+    return *this;
+}
+
+void compile_statistics::print(std::ostream& out) const {
+    auto microseconds = [](std::chrono::nanoseconds time) { return std::chrono::duration_cast<std::chrono::microseconds>(time).count(); };
+    out << compilations << " compilation(s)\n";
+    out << std::left << std::setw(24) << "phase" << std::right << std::setw(12) << "time [us]" << '\n';
+    for (unsigned i = 0; i < NUMBER_OF_PHASES; ++i) {
+        out << std::left << std::setw(24) << phase_names[i] << std::right << std::setw(12) << microseconds(phase_times[i]) << '\n';
+    }
+    out << "bytes lexed: " << bytes_lexed << ", tokens: " << tokens << ", parse tree nodes: " << parse_tree_nodes
+        << ", AST nodes: " << ast_nodes << ", symbols: " << symbols << '\n';
+    if (!passes.empty()) optimization::print_pass_statistics(out, passes);
+}
+
+} // namespace pljit
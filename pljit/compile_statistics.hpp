@@ -0,0 +1,79 @@
+#ifndef PLJIT_COMPILE_STATISTICS_HPP
+#define PLJIT_COMPILE_STATISTICS_HPP
+
+#include "pljit/optimization/pass_manager.hpp"
+#include "pljit/parser/parser_fwd.hpp"
+#include "pljit/semantic_analysis/ast_fwd.hpp"
+#include <chrono>
+#include <cstddef>
+#include <iosfwd>
+#include <vector>
+
+namespace pljit {
+
+/// Measurements of compilations, collected if function_options::collect_compile_statistics is set
+struct compile_statistics {
+    enum phase : unsigned {
+        /// The lexer runs on demand of the parser, so both share one phase
+        PARSE,
+        SEMANTIC_ANALYSIS,
+        OPTIMIZATION,
+        CODE_GENERATION,
+        /// Loading and storing ASTs in the disk cache
+        DISK_CACHE,
+        NUMBER_OF_PHASES
+    };
+    static constexpr const char* phase_names[NUMBER_OF_PHASES] = {"parse", "semantic analysis", "optimization", "code generation", "disk cache"};
+
+    /// Number of compilations summed up, 1 for a single function
+    unsigned compilations = 0;
+    std::chrono::nanoseconds phase_times[NUMBER_OF_PHASES]{};
+    std::size_t bytes_lexed = 0;
+    std::size_t tokens = 0;
+    /// Non-terminal nodes, the terminal nodes are the tokens
+    std::size_t parse_tree_nodes = 0;
+    std::size_t ast_nodes = 0;
+    std::size_t symbols = 0;
+    /// Empty if no pass ran, e.g. because the AST was loaded from the disk cache
+    std::vector<optimization::pass_statistics> passes;
+
+    /// Counts tokens and non-terminal nodes
+    void count(const parser::function_definition_node& parse_tree);
+    /// Counts AST nodes and symbols
+    void count(semantic_analysis::FunctionNode& ast);
+
+    std::chrono::nanoseconds total_time() const;
+
+    /// Sums up all counters and times, passes are matched by name
+    compile_statistics& operator+=(const compile_statistics& other);
+
+    void print(std::ostream& out) const;
+};
+
+/// Attributes wall time to the phases of a compilation, does nothing without statistics
+class phase_timer {
+    compile_statistics* statistics;
+    std::chrono::steady_clock::time_point start;
+
+    public:
+    explicit phase_timer(compile_statistics* statistics) : statistics(statistics) {
+        if (statistics) start = std::chrono::steady_clock::now();
+    }
+
+    /// Adds the time since construction, the last end_phase or restart to phase
+    void end_phase(compile_statistics::phase phase) {
+        if (!statistics) return;
+        const auto now = std::chrono::steady_clock::now();
+        statistics->phase_times[phase] += now - start;
+        start = now;
+    }
+
+    /// Excludes the time since the last end_phase from every phase
+    void restart() {
+        if (statistics) start = std::chrono::steady_clock::now();
+    }
+};
+
+} // namespace pljit
+
+#endif //PLJIT_COMPILE_STATISTICS_HPP
@@ -2,11 +2,11 @@
 
 namespace pljit::execution {
 int64_t ExecutionContext::get_value(unsigned int variable_id) const {
-    return symbols[variable_id];
+    return frame[variable_id];
 }
 
 void ExecutionContext::set_value(unsigned int variable_id, int64_t value) {
-    symbols[variable_id] = value;
+    frame[variable_id] = value;
 }
 
 void ExecutionContext::set_result(std::optional<int64_t> res) {
@@ -21,8 +21,32 @@ ExecutionContext::operator bool() const {
     return result.has_value();
 }
 
+// Copies have to point to their own storage, unless the frame belongs to the caller
+ExecutionContext::ExecutionContext(const ExecutionContext& other)
+    : symbols(other.symbols), frame(other.symbols.empty() ? other.frame : symbols.data()), result(other.result) {}
+
+ExecutionContext::ExecutionContext(ExecutionContext&& other) noexcept
+    : symbols(std::move(other.symbols)), frame(symbols.empty() ? other.frame : symbols.data()), result(other.result) {}
+
+ExecutionContext& ExecutionContext::operator=(const ExecutionContext& other) {
+    if (this != &other) {
+        symbols = other.symbols;
+        frame = other.symbols.empty() ? other.frame : symbols.data();
+        result = other.result;
+    }
+    return *this;
+}
+
+ExecutionContext& ExecutionContext::operator=(ExecutionContext&& other) noexcept {
+    symbols = std::move(other.symbols);
+    frame = symbols.empty() ? other.frame : symbols.data();
+    result = other.result;
+    return *this;
+}
+
 ExecutionContext::ExecutionContext(const semantic_analysis::symbol_table& symbolTable, const std::vector<int64_t>& parameters) {
     symbols.resize(symbolTable.size());
+    frame = symbols.data();
     std::copy(parameters.begin(), parameters.end(), symbols.begin());
 
     for (auto next_constant = symbolTable.constants_begin(); next_constant != symbolTable.constants_end(); ++next_constant) {
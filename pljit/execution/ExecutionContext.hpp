@@ -1,4 +1,3 @@
-
 #ifndef PLJIT_EXECUTIONCONTEXT_HPP
 #define PLJIT_EXECUTIONCONTEXT_HPP
 
@@ -10,7 +9,9 @@
 namespace pljit::execution {
 
 class ExecutionContext {
+    // Owned storage for the symbols. Empty if the context works on a frame provided by the caller.
     std::vector<int64_t> symbols;
+    int64_t* frame = nullptr;
     std::optional<int64_t> result;
 
     public:
@@ -24,6 +25,7 @@ class ExecutionContext {
         // Add parameters
         (symbols.push_back(param), ...);
         symbols.resize(symbolTable.size());
+        frame = symbols.data();
 
         for (auto next_constant = symbolTable.constants_begin(); next_constant != symbolTable.constants_end(); ++next_constant) {
             assert(next_constant->initialized);
@@ -32,6 +34,15 @@ class ExecutionContext {
     }
 
     explicit ExecutionContext(const pljit::semantic_analysis::symbol_table& symbolTable, const std::vector<int64_t>& parameters);
+    /// Works on a frame owned by the caller, which has to be initialized already. Does not allocate.
+    explicit ExecutionContext(int64_t* frame) : frame(frame) {}
+
+    ExecutionContext(const ExecutionContext& other);
+    ExecutionContext(ExecutionContext&& other) noexcept;
+    ExecutionContext& operator=(const ExecutionContext& other);
+    ExecutionContext& operator=(ExecutionContext&& other) noexcept;
+    ~ExecutionContext() = default;
+
     explicit operator bool() const;
     void set_value(unsigned variable_id, int64_t value);
     int64_t get_value(unsigned variable_id) const;
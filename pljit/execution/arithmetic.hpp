@@ -0,0 +1,39 @@
+#ifndef PLJIT_ARITHMETIC_HPP
+#define PLJIT_ARITHMETIC_HPP
+
+#include "pljit/source_management/diagnostics.hpp"
+#include <cstdint>
+#include <ostream>
+
+namespace pljit::execution {
+
+// PL arithmetic wraps around on overflow. Compute in unsigned arithmetic, where overflow is well defined.
+inline int64_t wrapping_add(int64_t lhs, int64_t rhs) {
+    return static_cast<int64_t>(static_cast<uint64_t>(lhs) + static_cast<uint64_t>(rhs));
+}
+
+inline int64_t wrapping_subtract(int64_t lhs, int64_t rhs) {
+    return static_cast<int64_t>(static_cast<uint64_t>(lhs) - static_cast<uint64_t>(rhs));
+}
+
+inline int64_t wrapping_multiply(int64_t lhs, int64_t rhs) {
+    return static_cast<int64_t>(static_cast<uint64_t>(lhs) * static_cast<uint64_t>(rhs));
+}
+
+inline int64_t wrapping_negate(int64_t value) {
+    return static_cast<int64_t>(0 - static_cast<uint64_t>(value));
+}
+
+/// Divides with INT64_MIN / -1 wrapping around. divisor must not be zero.
+inline int64_t wrapping_divide(int64_t dividend, int64_t divisor) {
+    return divisor == -1 ? wrapping_negate(dividend) : dividend / divisor;
+}
+
+/// Reports a division by zero, after which the call fails. Every engine reports it the same way.
+inline void report_division_by_zero() {
+    source_management::diagnostics() << "Error: Division by zero" << std::endl;
+}
+
+} // namespace pljit::execution
+
+#endif //PLJIT_ARITHMETIC_HPP
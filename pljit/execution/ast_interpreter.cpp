@@ -0,0 +1,32 @@
+#include "ast_interpreter.hpp"
+#include "pljit/execution/ExecutionContext.hpp"
+#include "pljit/semantic_analysis/AST.hpp"
+#include <algorithm>
+
+namespace pljit::execution {
+
+ast_interpreter::ast_interpreter(std::unique_ptr<semantic_analysis::FunctionNode> ast)
+    : ast(std::move(ast)), frame_template(create_frame_template(this->ast->getSymbolTable())) {}
+
+ast_interpreter::~ast_interpreter() = default;
+
+std::optional<int64_t> ast_interpreter::execute_impl(const int64_t* parameters, int64_t* frame) const {
+    return evaluate(*ast, frame_template, parameters, frame);
+}
+
+std::vector<int64_t> ast_interpreter::create_frame_template(const semantic_analysis::symbol_table& symbols) {
+    std::vector<int64_t> frame_template(symbols.size(), 0);
+    for (auto constant = symbols.constants_begin(); constant != symbols.constants_end(); ++constant) {
+        frame_template[constant->id] = constant->get_value();
+    }
+    return frame_template;
+}
+
+std::optional<int64_t> ast_interpreter::evaluate(semantic_analysis::FunctionNode& ast, const std::vector<int64_t>& frame_template, const int64_t* parameters, int64_t* frame) {
+    std::copy(frame_template.begin(), frame_template.end(), frame);
+    std::copy(parameters, parameters + ast.getSymbolTable().get_number_of_parameters(), frame);
+    ExecutionContext context(frame);
+    return ast.evaluate(context);
+}
+
+} // namespace pljit::execution
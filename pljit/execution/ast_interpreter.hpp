@@ -0,0 +1,40 @@
+#ifndef PLJIT_AST_INTERPRETER_HPP
+#define PLJIT_AST_INTERPRETER_HPP
+
+#include "pljit/execution/compiled_function.hpp"
+#include <memory>
+#include <vector>
+
+namespace pljit::semantic_analysis {
+class FunctionNode;
+class symbol_table;
+} // namespace pljit::semantic_analysis
+
+namespace pljit::execution {
+
+/// Owns an AST and evaluates it on every call. Lets an (optimized) AST be used wherever compiled code is expected.
+class ast_interpreter : public compiled_function {
+    std::unique_ptr<semantic_analysis::FunctionNode> ast;
+    /// Initial frame contents, constants are in place
+    std::vector<int64_t> frame_template;
+
+    protected:
+    std::optional<int64_t> execute_impl(const int64_t* parameters, int64_t* frame) const override;
+
+    public:
+    explicit ast_interpreter(std::unique_ptr<semantic_analysis::FunctionNode> ast);
+    ~ast_interpreter() override;
+
+    std::size_t get_frame_size() const override {
+        return frame_template.size();
+    }
+
+    /// @return A frame with every constant set and all other symbols zero
+    static std::vector<int64_t> create_frame_template(const semantic_analysis::symbol_table& symbols);
+    /// Initializes frame from frame_template and evaluates the AST on it
+    static std::optional<int64_t> evaluate(semantic_analysis::FunctionNode& ast, const std::vector<int64_t>& frame_template, const int64_t* parameters, int64_t* frame);
+};
+
+} // namespace pljit::execution
+
+#endif //PLJIT_AST_INTERPRETER_HPP
@@ -0,0 +1,39 @@
+#include "atomic_wait.hpp"
+#include <thread>
+#ifdef __linux__
+#include <climits>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace pljit::execution {
+
+#ifdef __linux__
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t) && std::atomic<uint32_t>::is_always_lock_free,
+              "The futex operates on the atomic word directly");
+
+void atomic_wait(const std::atomic<uint32_t>& word, uint32_t expected) {
+    // The kernel re-checks the value, so a notify between the load and the syscall is not lost
+    if (word.load(std::memory_order_acquire) != expected) return;
+    syscall(SYS_futex, reinterpret_cast<const uint32_t*>(&word), FUTEX_WAIT_PRIVATE, expected, nullptr, nullptr, 0);
+}
+
+void atomic_notify_one(std::atomic<uint32_t>& word) {
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+}
+
+void atomic_notify_all(std::atomic<uint32_t>& word) {
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+}
+#else
+void atomic_wait(const std::atomic<uint32_t>& word, uint32_t expected) {
+    if (word.load(std::memory_order_acquire) == expected) std::this_thread::yield();
+}
+
+void atomic_notify_one(std::atomic<uint32_t>&) {}
+
+void atomic_notify_all(std::atomic<uint32_t>&) {}
+#endif
+
+} // namespace pljit::execution
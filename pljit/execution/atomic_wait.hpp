@@ -0,0 +1,23 @@
+#ifndef PLJIT_ATOMIC_WAIT_HPP
+#define PLJIT_ATOMIC_WAIT_HPP
+
+#include <atomic>
+#include <cstdint>
+
+namespace pljit::execution {
+
+/**
+ * Blocks until word no longer holds expected, like std::atomic::wait of C++20. May return spuriously,
+ * callers have to re-check the value.
+ */
+void atomic_wait(const std::atomic<uint32_t>& word, uint32_t expected);
+
+/// Wakes one thread blocked in atomic_wait on word
+void atomic_notify_one(std::atomic<uint32_t>& word);
+
+/// Wakes every thread blocked in atomic_wait on word
+void atomic_notify_all(std::atomic<uint32_t>& word);
+
+} // namespace pljit::execution
+
+#endif //PLJIT_ATOMIC_WAIT_HPP
@@ -0,0 +1,188 @@
+#include "batch_evaluator.hpp"
+#include "pljit/execution/arithmetic.hpp"
+#include "pljit/semantic_analysis/AST.hpp"
+#include <algorithm>
+
+using namespace pljit::semantic_analysis;
+
+namespace pljit::execution {
+
+namespace {
+// Kernels over contiguous columns. They are kept free of branches and aliasing so they vectorize.
+template <class operation>
+void apply(const int64_t* __restrict lhs, const int64_t* __restrict rhs, int64_t* __restrict out, std::size_t rows, operation op) {
+    for (std::size_t i = 0; i < rows; ++i) out[i] = op(lhs[i], rhs[i]);
+}
+
+template <class operation>
+void apply_scalar_rhs(const int64_t* __restrict lhs, int64_t rhs, int64_t* __restrict out, std::size_t rows, operation op) {
+    for (std::size_t i = 0; i < rows; ++i) out[i] = op(lhs[i], rhs);
+}
+
+template <class operation>
+void apply_scalar_lhs(int64_t lhs, const int64_t* __restrict rhs, int64_t* __restrict out, std::size_t rows, operation op) {
+    for (std::size_t i = 0; i < rows; ++i) out[i] = op(lhs, rhs[i]);
+}
+
+struct add_operation {
+    int64_t operator()(int64_t lhs, int64_t rhs) const { return wrapping_add(lhs, rhs); }
+};
+struct subtract_operation {
+    int64_t operator()(int64_t lhs, int64_t rhs) const { return wrapping_subtract(lhs, rhs); }
+};
+struct multiply_operation {
+    int64_t operator()(int64_t lhs, int64_t rhs) const { return wrapping_multiply(lhs, rhs); }
+};
+
+/// Applies op to two operands of which at least one is a column
+template <class operation>
+void apply_columns(const int64_t* lhs, int64_t lhs_scalar, const int64_t* rhs, int64_t rhs_scalar, int64_t* out, std::size_t rows) {
+    if (!lhs) {
+        apply_scalar_lhs(lhs_scalar, rhs, out, rows, operation{});
+    } else if (!rhs) {
+        apply_scalar_rhs(lhs, rhs_scalar, out, rows, operation{});
+    } else {
+        apply(lhs, rhs, out, rows, operation{});
+    }
+}
+
+void divide(const int64_t* lhs, int64_t lhs_scalar, const int64_t* rhs, int64_t rhs_scalar, int64_t* out, uint8_t* errors, std::size_t rows) {
+    for (std::size_t i = 0; i < rows; ++i) {
+        const int64_t dividend = lhs ? lhs[i] : lhs_scalar;
+        const int64_t divisor = rhs ? rhs[i] : rhs_scalar;
+        // Failed rows continue with an arbitrary value, their result is discarded
+        errors[i] |= divisor == 0;
+        out[i] = divisor == 0 ? 0 : wrapping_divide(dividend, divisor);
+    }
+}
+} // namespace
+
+batch_evaluator::batch_evaluator(const symbol_table& symbols)
+    : symbols(symbols), frame(symbols.size()), symbol_storage(symbols.size()) {}
+
+auto batch_evaluator::evaluate(ExpressionNode& node) -> column {
+    node.accept(*this);
+    return value;
+}
+
+int64_t* batch_evaluator::allocate_temporary() {
+    if (next_temporary == temporaries.size()) {
+        temporaries.emplace_back(tile_size);
+    }
+    return temporaries[next_temporary++].data();
+}
+
+void batch_evaluator::evaluate(FunctionNode& function, const int64_t* const* parameter_columns, std::size_t n, int64_t* out, uint8_t* error_mask) {
+    for (std::size_t begin = 0; begin < n; begin += tile_size) {
+        rows = std::min(tile_size, n - begin);
+        errors = error_mask + begin;
+        result = out + begin;
+        std::fill_n(errors, rows, 0);
+
+        for (symbol_table::size_type i = 0; i < symbols.size(); ++i) {
+            const auto& symbol = symbols.get(i);
+            if (symbol.type == symbol::PARAMETER) {
+                frame[i] = {parameter_columns[i] + begin, 0};
+            } else if (symbol.type == symbol::CONSTANT) {
+                frame[i] = {nullptr, symbol.get_value()};
+            } else {
+                // Variables start out as 0 in every tile, not with the rows of the previous one
+                frame[i] = {nullptr, 0};
+            }
+        }
+        function.accept(*this);
+    }
+}
+
+void batch_evaluator::visit(FunctionNode& node) {
+    for (unsigned i = 0; i < node.get_number_of_statements(); ++i) {
+        next_temporary = 0;
+        node.get_statement(i)->accept(*this);
+        // Anything after the first return is unreachable
+        if (node.get_statement(i)->getType() == ASTNode::ReturnStatement) break;
+    }
+}
+
+void batch_evaluator::visit(IdentifierNode& node) {
+    value = frame[node.get_symbol_handle()];
+}
+
+void batch_evaluator::visit(LiteralNode& node) {
+    value = {nullptr, node.get_value()};
+}
+
+void batch_evaluator::visit(ReturnStatementNode& node) {
+    auto returned = evaluate(node.get_expression());
+    if (returned.is_scalar()) {
+        std::fill_n(result, rows, returned.scalar);
+    } else {
+        std::copy_n(returned.values, rows, result);
+    }
+}
+
+void batch_evaluator::visit(AssignmentNode& node) {
+    auto assigned = evaluate(node.get_expression());
+    const auto symbol = node.get_identifier().get_symbol_handle();
+    if (assigned.is_scalar()) {
+        frame[symbol] = assigned;
+        return;
+    }
+    // Temporaries are reused by the next statement, so keep a copy
+    auto& storage = symbol_storage[symbol];
+    storage.resize(tile_size);
+    std::copy_n(assigned.values, rows, storage.data());
+    frame[symbol] = {storage.data(), 0};
+}
+
+void batch_evaluator::visit(UnaryOperatorASTNode& node) {
+    auto input = evaluate(node.getInput());
+    if (node.get_operator() == UnaryOperatorASTNode::OperatorType::PLUS) {
+        value = input;
+        return;
+    }
+    if (input.is_scalar()) {
+        value = {nullptr, wrapping_negate(input.scalar)};
+        return;
+    }
+    int64_t* out = allocate_temporary();
+    apply_scalar_lhs(0, input.values, out, rows, subtract_operation{});
+    value = {out, 0};
+}
+
+void batch_evaluator::visit(BinaryOperatorASTNode& node) {
+    auto lhs = evaluate(node.getLeft());
+    auto rhs = evaluate(node.getRight());
+    const auto operation = node.get_operator();
+
+    if (operation == BinaryOperatorASTNode::OperatorType::DIVIDE) {
+        if (lhs.is_scalar() && rhs.is_scalar() && rhs.scalar != 0) {
+            value = {nullptr, wrapping_divide(lhs.scalar, rhs.scalar)};
+            return;
+        }
+        int64_t* out = allocate_temporary();
+        divide(lhs.values, lhs.scalar, rhs.values, rhs.scalar, out, errors, rows);
+        value = {out, 0};
+        return;
+    }
+
+    if (lhs.is_scalar() && rhs.is_scalar()) {
+        switch (operation) {
+            case BinaryOperatorASTNode::OperatorType::PLUS: value = {nullptr, wrapping_add(lhs.scalar, rhs.scalar)}; break;
+            case BinaryOperatorASTNode::OperatorType::MINUS: value = {nullptr, wrapping_subtract(lhs.scalar, rhs.scalar)}; break;
+            case BinaryOperatorASTNode::OperatorType::MULTIPLY: value = {nullptr, wrapping_multiply(lhs.scalar, rhs.scalar)}; break;
+            case BinaryOperatorASTNode::OperatorType::DIVIDE: break;
+        }
+        return;
+    }
+
+    int64_t* out = allocate_temporary();
+    switch (operation) {
+        case BinaryOperatorASTNode::OperatorType::PLUS: apply_columns<add_operation>(lhs.values, lhs.scalar, rhs.values, rhs.scalar, out, rows); break;
+        case BinaryOperatorASTNode::OperatorType::MINUS: apply_columns<subtract_operation>(lhs.values, lhs.scalar, rhs.values, rhs.scalar, out, rows); break;
+        case BinaryOperatorASTNode::OperatorType::MULTIPLY: apply_columns<multiply_operation>(lhs.values, lhs.scalar, rhs.values, rhs.scalar, out, rows); break;
+        case BinaryOperatorASTNode::OperatorType::DIVIDE: break;
+    }
+    value = {out, 0};
+}
+
+} // namespace pljit::execution
@@ -0,0 +1,70 @@
+#ifndef PLJIT_BATCH_EVALUATOR_HPP
+#define PLJIT_BATCH_EVALUATOR_HPP
+
+#include "pljit/semantic_analysis/ast_visitor.hpp"
+#include "pljit/semantic_analysis/symbol_table.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace pljit::execution {
+
+/**
+ * Evaluates a function for many parameter tuples at once. Rows are processed in tiles: every statement is
+ * interpreted once per tile and each operation runs as a tight loop over the tile's columns, which the
+ * compiler vectorizes. Errors are recorded per row and do not abort the batch.
+ */
+class batch_evaluator : public semantic_analysis::ast_visitor {
+    public:
+    static constexpr std::size_t tile_size = 1024;
+
+    private:
+    /// Either a column of tile_size values or a single value shared by all rows
+    struct column {
+        const int64_t* values = nullptr;
+        int64_t scalar = 0;
+
+        bool is_scalar() const {
+            return values == nullptr;
+        }
+    };
+
+    const semantic_analysis::symbol_table& symbols;
+    /// Current value of every symbol
+    std::vector<column> frame;
+    /// Storage for assigned symbols
+    std::vector<std::vector<int64_t>> symbol_storage;
+    /// Storage for intermediate results, reused by every statement
+    std::vector<std::vector<int64_t>> temporaries;
+    std::size_t next_temporary = 0;
+    /// Rows of the current tile
+    std::size_t rows = 0;
+    uint8_t* errors = nullptr;
+    int64_t* result = nullptr;
+    column value;
+
+    column evaluate(semantic_analysis::ExpressionNode& node);
+    int64_t* allocate_temporary();
+
+    public:
+    explicit batch_evaluator(const semantic_analysis::symbol_table& symbols);
+
+    /**
+     * @param parameter_columns One column of n values per parameter
+     * @param out Receives the result of each row
+     * @param error_mask Set to 1 for rows whose execution failed, 0 otherwise
+     */
+    void evaluate(semantic_analysis::FunctionNode& function, const int64_t* const* parameter_columns, std::size_t n, int64_t* out, uint8_t* error_mask);
+
+    void visit(semantic_analysis::FunctionNode& node) override;
+    void visit(semantic_analysis::IdentifierNode& node) override;
+    void visit(semantic_analysis::LiteralNode& node) override;
+    void visit(semantic_analysis::ReturnStatementNode& node) override;
+    void visit(semantic_analysis::AssignmentNode& node) override;
+    void visit(semantic_analysis::UnaryOperatorASTNode& node) override;
+    void visit(semantic_analysis::BinaryOperatorASTNode& node) override;
+};
+
+} // namespace pljit::execution
+
+#endif //PLJIT_BATCH_EVALUATOR_HPP
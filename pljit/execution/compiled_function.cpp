@@ -0,0 +1,18 @@
+#include "compiled_function.hpp"
+#include <vector>
+
+namespace pljit::execution {
+
+std::optional<int64_t> compiled_function::execute(const int64_t* parameters) const {
+    const std::size_t frame_size = get_frame_size();
+    if (frame_size <= inline_frame_size) {
+        int64_t frame[inline_frame_size];
+        return execute_impl(parameters, frame);
+    }
+    // Grows to the largest frame once per thread, functions do not recurse
+    thread_local std::vector<int64_t> large_frame;
+    if (large_frame.size() < frame_size) large_frame.resize(frame_size);
+    return execute_impl(parameters, large_frame.data());
+}
+
+} // namespace pljit::execution
@@ -0,0 +1,43 @@
+#ifndef PLJIT_COMPILED_FUNCTION_HPP
+#define PLJIT_COMPILED_FUNCTION_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+namespace pljit::execution {
+
+/**
+ * Executable representation of a function produced by one of the execution engines. The AST
+ * interpreter does not need one, it evaluates the FunctionNode directly.
+ */
+class compiled_function {
+    protected:
+    virtual std::optional<int64_t> execute_impl(const int64_t* parameters, int64_t* frame) const = 0;
+
+    public:
+    /// Frames with at most this many slots are placed on the stack by execute(parameters)
+    static constexpr std::size_t inline_frame_size = 64;
+
+    /// Number of int64_t slots the function needs as scratch memory
+    virtual std::size_t get_frame_size() const = 0;
+
+    /**
+     * Runs the function without allocating.
+     * @param parameters One value per declared parameter
+     * @param frame Scratch memory of get_frame_size() slots
+     * @return The result or std::nullopt if execution failed, e.g. due to a division by zero
+     */
+    std::optional<int64_t> execute(const int64_t* parameters, int64_t* frame) const {
+        return execute_impl(parameters, frame);
+    }
+
+    /// Runs the function with a frame on the stack, or in a reused thread local buffer for large functions
+    std::optional<int64_t> execute(const int64_t* parameters) const;
+
+    virtual ~compiled_function() = default;
+};
+
+} // namespace pljit::execution
+
+#endif //PLJIT_COMPILED_FUNCTION_HPP
@@ -0,0 +1,52 @@
+#include "function_registry.hpp"
+#include "pljit/Pljit.hpp"
+
+namespace pljit {
+
+std::pair<unsigned, std::size_t> function_registry::locate(uint32_t id) {
+    // Segment k starts at id (2^k - 1) * 2^first_segment_bits
+    const uint64_t biased = uint64_t{id} + segment_size(0);
+#if defined(__GNUC__)
+    const unsigned highest_bit = 63 - __builtin_clzll(biased);
+#else
+    unsigned highest_bit = 0;
+    while ((biased >> (highest_bit + 1)) != 0) ++highest_bit;
+#endif
+    const unsigned segment = highest_bit - first_segment_bits;
+    return {segment, biased - segment_size(segment)};
+}
+
+function_registry::slot* function_registry::get_segment(unsigned segment) {
+    slot* existing = segments[segment].load(std::memory_order_acquire);
+    if (existing) return existing;
+
+    auto* allocated = new slot[segment_size(segment)]();
+    if (segments[segment].compare_exchange_strong(existing, allocated, std::memory_order_acq_rel)) {
+        return allocated;
+    }
+    // Another thread was faster
+    delete[] allocated;
+    return existing;
+}
+
+uint32_t function_registry::add(std::unique_ptr<Function> function) {
+    const uint32_t id = next_id.fetch_add(1, std::memory_order_relaxed);
+    auto [segment, offset] = locate(id);
+    assert(segment < number_of_segments);
+    get_segment(segment)[offset].store(function.release(), std::memory_order_release);
+    return id;
+}
+
+function_registry::~function_registry() {
+    for (unsigned segment = 0; segment < number_of_segments; ++segment) {
+        slot* slots = segments[segment].load(std::memory_order_acquire);
+        // Ids are contiguous, so are the allocated segments
+        if (!slots) break;
+        for (std::size_t i = 0; i < segment_size(segment); ++i) {
+            delete slots[i].load(std::memory_order_relaxed);
+        }
+        delete[] slots;
+    }
+}
+
+} // namespace pljit
@@ -0,0 +1,76 @@
+#ifndef PLJIT_FUNCTION_REGISTRY_HPP
+#define PLJIT_FUNCTION_REGISTRY_HPP
+
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+namespace pljit {
+
+class Function;
+
+/**
+ * Append-only storage of the registered functions. Registration and lookup may run concurrently,
+ * lookups never block. Entries live in segments of doubling size that are never moved, so a
+ * Function* stays valid until the registry is destroyed.
+ */
+class function_registry {
+    static constexpr unsigned first_segment_bits = 6;
+    static constexpr unsigned number_of_segments = 26;
+
+    using slot = std::atomic<Function*>;
+
+    std::array<std::atomic<slot*>, number_of_segments> segments{};
+    std::atomic<uint32_t> next_id{0};
+
+    static constexpr std::size_t segment_size(unsigned segment) {
+        return std::size_t{1} << (first_segment_bits + segment);
+    }
+
+    /// @return Segment and offset within the segment of id
+    static std::pair<unsigned, std::size_t> locate(uint32_t id);
+
+    /// Allocates the segment if no other thread did so yet
+    slot* get_segment(unsigned segment);
+
+    public:
+    function_registry() = default;
+    function_registry(const function_registry&) = delete;
+    function_registry& operator=(const function_registry&) = delete;
+    ~function_registry();
+
+    /// Takes ownership of function
+    /// @return Id of the function
+    uint32_t add(std::unique_ptr<Function> function);
+
+    /// Lock-free, id has to be returned by add before
+    Function& get(uint32_t id) const {
+        auto [segment, offset] = locate(id);
+        Function* function = segments[segment].load(std::memory_order_acquire)[offset].load(std::memory_order_acquire);
+        assert(function);
+        return *function;
+    }
+
+    /// Lock-free, any id below size() may be passed
+    /// @return The function, nullptr while its registration is still in progress
+    Function* try_get(uint32_t id) const {
+        auto [segment, offset] = locate(id);
+        slot* slots = segments[segment].load(std::memory_order_acquire);
+        // The segment is allocated by the add that publishes the function
+        if (!slots) return nullptr;
+        return slots[offset].load(std::memory_order_acquire);
+    }
+
+    /// Number of ids handed out so far. Functions with the highest ids might still be in the process of registration,
+    /// use try_get to skip them.
+    uint32_t size() const {
+        return next_id.load(std::memory_order_relaxed);
+    }
+};
+
+} // namespace pljit
+
+#endif //PLJIT_FUNCTION_REGISTRY_HPP
@@ -0,0 +1,66 @@
+#include "ast_lowering.hpp"
+#include "pljit/semantic_analysis/AST.hpp"
+
+using namespace pljit::semantic_analysis;
+
+namespace pljit::ir {
+
+namespace {
+
+BinaryOperatorASTNode::OperatorType binary_operator(opcode operation) {
+    switch (operation) {
+        case opcode::ADD: return BinaryOperatorASTNode::OperatorType::PLUS;
+        case opcode::SUBTRACT: return BinaryOperatorASTNode::OperatorType::MINUS;
+        case opcode::MULTIPLY: return BinaryOperatorASTNode::OperatorType::MULTIPLY;
+        default: return BinaryOperatorASTNode::OperatorType::DIVIDE;
+    }
+}
+
+} // namespace
+
+ast_lowering::ast_lowering(const ssa_function& function) : function(function), uses(function.values.size(), 0), variables(function.values.size()) {
+    for (const auto& definition : function.values) {
+        if (definition.operation == opcode::NEGATE || definition.is_binary()) ++uses[definition.lhs];
+        if (definition.is_binary()) ++uses[definition.rhs];
+    }
+    ++uses[function.result];
+}
+
+std::unique_ptr<ExpressionNode> ast_lowering::expression(value_id value) const {
+    if (variables[value]) return std::make_unique<IdentifierNode>(*variables[value]);
+    const auto& definition = function.values[value];
+    switch (definition.operation) {
+        case opcode::PARAMETER: return std::make_unique<IdentifierNode>(static_cast<symbol_table::symbol_handle>(definition.immediate));
+        case opcode::CONSTANT: return std::make_unique<LiteralNode>(definition.immediate);
+        case opcode::NEGATE: return std::make_unique<UnaryOperatorASTNode>(expression(definition.lhs), UnaryOperatorASTNode::OperatorType::MINUS);
+        default: return std::make_unique<BinaryOperatorASTNode>(expression(definition.lhs), binary_operator(definition.operation), expression(definition.rhs));
+    }
+}
+
+std::unique_ptr<FunctionNode> ast_lowering::lower(const ssa_function& function, const symbol_table& symbols) {
+    ast_lowering lowering(function);
+    symbol_table lowered_symbols;
+    for (symbol_table::symbol_handle handle = 0; handle < function.number_of_parameters; ++handle) {
+        lowered_symbols.insert(symbols.get(handle).declaration, symbol::PARAMETER, std::nullopt);
+    }
+
+    std::vector<value_id> materialized;
+    for (value_id value = 0; value < function.values.size(); ++value) {
+        const auto operation = function.values[value].operation;
+        if (operation == opcode::PARAMETER || operation == opcode::CONSTANT) continue;
+        if (lowering.uses[value] != 1) materialized.push_back(value);
+    }
+    auto next_variable = lowered_symbols.insert_variables(materialized.size());
+
+    std::vector<std::unique_ptr<StatementNode>> statements;
+    for (auto value : materialized) {
+        // The operands are inlined or assigned already
+        auto value_expression = lowering.expression(value);
+        lowering.variables[value] = next_variable++;
+        statements.push_back(std::make_unique<AssignmentNode>(std::make_unique<IdentifierNode>(*lowering.variables[value]), std::move(value_expression)));
+    }
+    statements.push_back(std::make_unique<ReturnStatementNode>(lowering.expression(function.result)));
+    return std::make_unique<FunctionNode>(std::move(statements), std::move(lowered_symbols));
+}
+
+} // namespace pljit::ir
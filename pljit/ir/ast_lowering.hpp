@@ -0,0 +1,33 @@
+#ifndef PLJIT_IR_AST_LOWERING_HPP
+#define PLJIT_IR_AST_LOWERING_HPP
+
+#include "pljit/ir/ssa.hpp"
+#include "pljit/semantic_analysis/ast_fwd.hpp"
+#include "pljit/semantic_analysis/symbol_table.hpp"
+#include <memory>
+
+namespace pljit::ir {
+
+/**
+ * Turns SSA form back into an AST, which every execution engine and backend consumes. Values used once are
+ * inlined into their user. Values used several times, and unused divisions that may fail, are assigned to a
+ * variable of their own in definition order. Constants become literals.
+ */
+class ast_lowering {
+    const ssa_function& function;
+    std::vector<uint32_t> uses;
+    /// Variable holding a value, if it gets one
+    std::vector<std::optional<semantic_analysis::symbol_table::symbol_handle>> variables;
+
+    explicit ast_lowering(const ssa_function& function);
+
+    std::unique_ptr<semantic_analysis::ExpressionNode> expression(value_id value) const;
+
+    public:
+    /// @param symbols Symbols of the source function, parameters keep their declaration
+    static std::unique_ptr<semantic_analysis::FunctionNode> lower(const ssa_function& function, const semantic_analysis::symbol_table& symbols);
+};
+
+} // namespace pljit::ir
+
+#endif //PLJIT_IR_AST_LOWERING_HPP
@@ -0,0 +1,63 @@
+#ifndef PLJIT_IR_SSA_HPP
+#define PLJIT_IR_SSA_HPP
+
+#include <cstdint>
+#include <vector>
+
+namespace pljit::ir {
+
+/// Index of a value in ssa_function::values
+using value_id = uint32_t;
+
+enum class opcode : uint8_t {
+    /// Parameter number immediate
+    PARAMETER,
+    /// The value immediate
+    CONSTANT,
+    /// -lhs, wraps around
+    NEGATE,
+    /// lhs <op> rhs, wraps around
+    ADD,
+    SUBTRACT,
+    MULTIPLY,
+    /// Fails on division by zero, INT64_MIN / -1 wraps around
+    DIVIDE
+};
+
+struct instruction {
+    opcode operation;
+    value_id lhs = 0;
+    value_id rhs = 0;
+    int64_t immediate = 0;
+
+    bool is_binary() const {
+        return operation >= opcode::ADD;
+    }
+    bool is_commutative() const {
+        return operation == opcode::ADD || operation == opcode::MULTIPLY;
+    }
+};
+
+/**
+ * Static single assignment form of a function. Functions are straight-line code, so this is a single basic
+ * block without phi nodes: every instruction defines one value and only uses values defined before it.
+ * Each assignment of the source defines a new value, symbols are only names for the value assigned last.
+ */
+struct ssa_function {
+    std::vector<instruction> values;
+    /// The value of the first return statement
+    value_id result = 0;
+    uint32_t number_of_parameters = 0;
+
+    /// Whether computing the value can fail, such a value has to be computed even if it is unused
+    bool may_fail(value_id value) const {
+        const auto& definition = values[value];
+        if (definition.operation != opcode::DIVIDE) return false;
+        const auto& divisor = values[definition.rhs];
+        return divisor.operation != opcode::CONSTANT || divisor.immediate == 0;
+    }
+};
+
+} // namespace pljit::ir
+
+#endif //PLJIT_IR_SSA_HPP
@@ -0,0 +1,77 @@
+#include "ssa_builder.hpp"
+#include "pljit/semantic_analysis/AST.hpp"
+
+using namespace pljit::semantic_analysis;
+
+namespace pljit::ir {
+
+ssa_builder::ssa_builder(ssa_function& function, const symbol_table& symbols) : function(function), current(symbols.size(), unassigned) {
+    function.number_of_parameters = static_cast<uint32_t>(symbols.get_number_of_parameters());
+    for (symbol_table::symbol_handle handle = 0; handle < symbols.size(); ++handle) {
+        const auto& symbol = symbols.get(handle);
+        if (symbol.type == symbol::PARAMETER) current[handle] = emit({opcode::PARAMETER, 0, 0, static_cast<int64_t>(handle)});
+        if (symbol.type == symbol::CONSTANT) current[handle] = emit({opcode::CONSTANT, 0, 0, symbol.get_value()});
+    }
+}
+
+value_id ssa_builder::emit(instruction definition) {
+    function.values.push_back(definition);
+    return static_cast<value_id>(function.values.size() - 1);
+}
+
+void ssa_builder::visit(FunctionNode& node) {
+    for (unsigned i = 0; i < node.get_number_of_statements() && !returned; ++i) {
+        node.get_statement(i)->accept(*this);
+    }
+}
+
+void ssa_builder::visit(IdentifierNode& node) {
+    auto& value = current[node.get_symbol_handle()];
+    // Variables start out as 0. The semantic analysis accepts x := x + 1 as the first assignment of x.
+    if (value == unassigned) value = emit({opcode::CONSTANT, 0, 0, 0});
+    result = value;
+}
+
+void ssa_builder::visit(LiteralNode& node) {
+    result = emit({opcode::CONSTANT, 0, 0, node.get_value()});
+}
+
+void ssa_builder::visit(ReturnStatementNode& node) {
+    node.get_expression().accept(*this);
+    function.result = result;
+    returned = true;
+}
+
+void ssa_builder::visit(AssignmentNode& node) {
+    node.get_expression().accept(*this);
+    current[node.get_identifier().get_symbol_handle()] = result;
+}
+
+void ssa_builder::visit(UnaryOperatorASTNode& node) {
+    node.getInput().accept(*this);
+    if (node.get_operator() == UnaryOperatorASTNode::OperatorType::MINUS) result = emit({opcode::NEGATE, result});
+}
+
+void ssa_builder::visit(BinaryOperatorASTNode& node) {
+    node.getLeft().accept(*this);
+    const auto lhs = result;
+    node.getRight().accept(*this);
+    const auto rhs = result;
+    opcode operation = opcode::ADD;
+    switch (node.get_operator()) {
+        case BinaryOperatorASTNode::OperatorType::PLUS: operation = opcode::ADD; break;
+        case BinaryOperatorASTNode::OperatorType::MINUS: operation = opcode::SUBTRACT; break;
+        case BinaryOperatorASTNode::OperatorType::MULTIPLY: operation = opcode::MULTIPLY; break;
+        case BinaryOperatorASTNode::OperatorType::DIVIDE: operation = opcode::DIVIDE; break;
+    }
+    result = emit({operation, lhs, rhs});
+}
+
+ssa_function ssa_builder::build(FunctionNode& function) {
+    ssa_function result;
+    ssa_builder builder(result, function.getSymbolTable());
+    function.accept(builder);
+    return result;
+}
+
+} // namespace pljit::ir
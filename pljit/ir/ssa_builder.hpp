@@ -0,0 +1,43 @@
+#ifndef PLJIT_IR_SSA_BUILDER_HPP
+#define PLJIT_IR_SSA_BUILDER_HPP
+
+#include "pljit/ir/ssa.hpp"
+#include "pljit/semantic_analysis/ast_visitor.hpp"
+#include "pljit/semantic_analysis/symbol_table.hpp"
+#include <limits>
+
+namespace pljit::ir {
+
+/**
+ * Translates an AST into SSA form. Reading a symbol refers to the value it was assigned last, so copies and
+ * unary plus disappear during construction. Statements after the first return are not translated.
+ */
+class ssa_builder : public semantic_analysis::ast_visitor {
+    ssa_function& function;
+    static constexpr value_id unassigned = std::numeric_limits<value_id>::max();
+
+    /// Value currently held by every symbol, unassigned for variables that were not assigned yet
+    std::vector<value_id> current;
+    /// Value of the last visited expression
+    value_id result = 0;
+    bool returned = false;
+
+    ssa_builder(ssa_function& function, const semantic_analysis::symbol_table& symbols);
+
+    value_id emit(instruction definition);
+
+    public:
+    void visit(semantic_analysis::FunctionNode& node) override;
+    void visit(semantic_analysis::IdentifierNode& node) override;
+    void visit(semantic_analysis::LiteralNode& node) override;
+    void visit(semantic_analysis::ReturnStatementNode& node) override;
+    void visit(semantic_analysis::AssignmentNode& node) override;
+    void visit(semantic_analysis::UnaryOperatorASTNode& node) override;
+    void visit(semantic_analysis::BinaryOperatorASTNode& node) override;
+
+    static ssa_function build(semantic_analysis::FunctionNode& function);
+};
+
+} // namespace pljit::ir
+
+#endif //PLJIT_IR_SSA_BUILDER_HPP
@@ -0,0 +1,106 @@
+#include "ssa_passes.hpp"
+#include "pljit/execution/arithmetic.hpp"
+#include <tuple>
+#include <unordered_map>
+
+namespace pljit::ir {
+
+namespace {
+
+int64_t fold(opcode operation, int64_t lhs, int64_t rhs) {
+    switch (operation) {
+        case opcode::NEGATE: return execution::wrapping_negate(lhs);
+        case opcode::ADD: return execution::wrapping_add(lhs, rhs);
+        case opcode::SUBTRACT: return execution::wrapping_subtract(lhs, rhs);
+        case opcode::MULTIPLY: return execution::wrapping_multiply(lhs, rhs);
+        case opcode::DIVIDE: return execution::wrapping_divide(lhs, rhs);
+        default: return 0;
+    }
+}
+
+struct instruction_hash {
+    std::size_t operator()(const instruction& definition) const {
+        std::size_t hash = static_cast<std::size_t>(definition.operation);
+        for (std::size_t part : {static_cast<std::size_t>(definition.lhs), static_cast<std::size_t>(definition.rhs), static_cast<std::size_t>(definition.immediate)}) {
+            hash ^= part + 0x9e3779b97f4a7c15 + (hash << 6) + (hash >> 2);
+        }
+        return hash;
+    }
+};
+
+struct instruction_equal {
+    bool operator()(const instruction& lhs, const instruction& rhs) const {
+        return std::tie(lhs.operation, lhs.lhs, lhs.rhs, lhs.immediate) == std::tie(rhs.operation, rhs.lhs, rhs.rhs, rhs.immediate);
+    }
+};
+
+} // namespace
+
+void propagate_constants(ssa_function& function) {
+    auto constant = [&](value_id value) { return function.values[value].operation == opcode::CONSTANT; };
+    for (auto& definition : function.values) {
+        if (definition.operation == opcode::NEGATE && constant(definition.lhs)) {
+            definition = {opcode::CONSTANT, 0, 0, fold(opcode::NEGATE, function.values[definition.lhs].immediate, 0)};
+        } else if (definition.is_binary() && constant(definition.lhs) && constant(definition.rhs)) {
+            const auto rhs = function.values[definition.rhs].immediate;
+            if (definition.operation == opcode::DIVIDE && rhs == 0) continue;
+            definition = {opcode::CONSTANT, 0, 0, fold(definition.operation, function.values[definition.lhs].immediate, rhs)};
+        }
+    }
+}
+
+void eliminate_common_subexpressions(ssa_function& function) {
+    std::vector<value_id> replacement(function.values.size());
+    std::unordered_map<instruction, value_id, instruction_hash, instruction_equal> numbers;
+    numbers.reserve(function.values.size());
+    for (value_id value = 0; value < function.values.size(); ++value) {
+        auto& definition = function.values[value];
+        if (definition.operation != opcode::PARAMETER && definition.operation != opcode::CONSTANT) {
+            definition.lhs = replacement[definition.lhs];
+            if (definition.is_binary()) definition.rhs = replacement[definition.rhs];
+        }
+        // Both operands are always evaluated, so commutative operations may swap them. Constants go to the right,
+        // like algebraic_simplification does on the AST.
+        if (definition.is_commutative()) {
+            const bool lhs_constant = function.values[definition.lhs].operation == opcode::CONSTANT;
+            const bool rhs_constant = function.values[definition.rhs].operation == opcode::CONSTANT;
+            if (lhs_constant != rhs_constant ? lhs_constant : definition.rhs < definition.lhs) std::swap(definition.lhs, definition.rhs);
+        }
+        replacement[value] = numbers.try_emplace(definition, value).first->second;
+    }
+    function.result = replacement[function.result];
+}
+
+void eliminate_dead_values(ssa_function& function) {
+    std::vector<bool> live(function.values.size(), false);
+    live[function.result] = true;
+    // Users come after their operands, so one backward sweep reaches every value
+    for (auto value = static_cast<value_id>(function.values.size()); value-- > 0;) {
+        if (!live[value] && !function.may_fail(value)) continue;
+        live[value] = true;
+        const auto& definition = function.values[value];
+        if (definition.operation == opcode::NEGATE || definition.is_binary()) live[definition.lhs] = true;
+        if (definition.is_binary()) live[definition.rhs] = true;
+    }
+
+    std::vector<value_id> renumbered(function.values.size());
+    value_id next = 0;
+    for (value_id value = 0; value < function.values.size(); ++value) {
+        if (!live[value]) continue;
+        auto definition = function.values[value];
+        if (definition.operation == opcode::NEGATE || definition.is_binary()) definition.lhs = renumbered[definition.lhs];
+        if (definition.is_binary()) definition.rhs = renumbered[definition.rhs];
+        function.values[next] = definition;
+        renumbered[value] = next++;
+    }
+    function.values.resize(next);
+    function.result = renumbered[function.result];
+}
+
+void optimize(ssa_function& function) {
+    propagate_constants(function);
+    eliminate_common_subexpressions(function);
+    eliminate_dead_values(function);
+}
+
+} // namespace pljit::ir
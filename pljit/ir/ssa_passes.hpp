@@ -0,0 +1,28 @@
+#ifndef PLJIT_IR_SSA_PASSES_HPP
+#define PLJIT_IR_SSA_PASSES_HPP
+
+#include "pljit/ir/ssa.hpp"
+
+namespace pljit::ir {
+
+/**
+ * Sparse analyses on SSA form. Operands are defined before their users and there is no control flow, so
+ * each analysis is a single sweep over the values and runs in linear time.
+ */
+
+/// Folds operations whose operands are constants. Without branches, sparse conditional constant propagation
+/// reduces to this forward sweep. Divisions by zero are left in place, they fail at run time.
+void propagate_constants(ssa_function& function);
+
+/// Gives equal operations on equal operands a single value (hash based value numbering)
+void eliminate_common_subexpressions(ssa_function& function);
+
+/// Removes values the result does not depend on, except divisions that may fail, and renumbers the rest
+void eliminate_dead_values(ssa_function& function);
+
+/// Runs all of the above
+void optimize(ssa_function& function);
+
+} // namespace pljit::ir
+
+#endif //PLJIT_IR_SSA_PASSES_HPP
@@ -7,6 +7,7 @@
 
 #include "pljit/source_management/SourceCode.hpp"
 #include "token.hpp"
+#include <optional>
 
 namespace pljit::lexer {
 
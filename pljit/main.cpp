@@ -1,8 +1,243 @@
+#include "pljit/codegen/elf/object_writer.hpp"
+#include "pljit/codegen/x86_64/code_generator.hpp"
+#include "pljit/lexer/lexer.hpp"
+#include "pljit/optimization/pass_manager.hpp"
+#include "pljit/parser/parser.hpp"
+#include "pljit/persistence/snapshot_image.hpp"
+#include "pljit/semantic_analysis/AST.hpp"
+#include "pljit/semantic_analysis/ASTCreator.hpp"
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
 #include <iostream>
+#include <sstream>
+#include <thread>
 //---------------------------------------------------------------------------
 using namespace std;
+using namespace pljit;
 //---------------------------------------------------------------------------
-int main() {
-    cout << "use for experiments" << endl;
+namespace {
+//---------------------------------------------------------------------------
+enum class output_format {
+    /// ELF relocatable object with one native function per input file
+    OBJECT,
+    /// Snapshot image with one bytecode function per input file
+    IMAGE
+};
+//---------------------------------------------------------------------------
+struct driver_options {
+    vector<filesystem::path> inputs;
+    filesystem::path output;
+    optimization::optimization_level optimization = optimization::optimization_level::O1;
+    output_format format = output_format::OBJECT;
+    unsigned threads = 0;
+};
+//---------------------------------------------------------------------------
+enum phase : unsigned {
+    READ,
+    PARSE,
+    SEMANTIC_ANALYSIS,
+    OPTIMIZATION,
+    CODE_GENERATION,
+    NUMBER_OF_PHASES
+};
+constexpr const char* phase_names[NUMBER_OF_PHASES] = {"read", "lex + parse", "semantic analysis", "optimization", "code generation"};
+//---------------------------------------------------------------------------
+struct compilation_result {
+    string symbol;
+    bool success = false;
+    vector<uint8_t> native_code;
+    optional<persistence::image_function> bytecode;
+    chrono::nanoseconds phase_times[NUMBER_OF_PHASES]{};
+};
+//---------------------------------------------------------------------------
+void print_usage() {
+    cerr << "Usage: pljit [-O0|-O1|-O2] [-j threads] [--format object|image] -o output file.pl...\n"
+            "Compiles every PL file into a function named after the file.\n"
+            "  object  ELF object exporting extern \"C\" bool name(const int64_t* parameters, int64_t* result)\n"
+            "  image   Snapshot image, function ids follow the order of the files"
+         << endl;
+}
+//---------------------------------------------------------------------------
+/// Decimal number, 0 picks one thread per core. std::nullopt for anything else.
+optional<unsigned> parse_thread_count(string_view argument) {
+    unsigned threads = 0;
+    const auto [end, error] = from_chars(argument.data(), argument.data() + argument.size(), threads);
+    if (error != errc() || end != argument.data() + argument.size()) return nullopt;
+    return threads;
+}
+//---------------------------------------------------------------------------
+optional<driver_options> parse_arguments(int argc, char* argv[]) {
+    driver_options options;
+    for (int i = 1; i < argc; ++i) {
+        string_view argument = argv[i];
+        if (argument == "-O0") {
+            options.optimization = optimization::optimization_level::O0;
+        } else if (argument == "-O1") {
+            options.optimization = optimization::optimization_level::O1;
+        } else if (argument == "-O2") {
+            options.optimization = optimization::optimization_level::O2;
+        } else if (argument == "-o" && i + 1 < argc) {
+            options.output = argv[++i];
+        } else if (argument == "-j" && i + 1 < argc) {
+            auto threads = parse_thread_count(argv[++i]);
+            if (!threads) return nullopt;
+            options.threads = *threads;
+        } else if (argument == "--format" && i + 1 < argc) {
+            string_view format = argv[++i];
+            if (format == "object") {
+                options.format = output_format::OBJECT;
+            } else if (format == "image") {
+                options.format = output_format::IMAGE;
+            } else {
+                return nullopt;
+            }
+        } else if (!argument.empty() && argument[0] == '-') {
+            return nullopt;
+        } else {
+            options.inputs.emplace_back(argument);
+        }
+    }
+    if (options.inputs.empty() || options.output.empty()) return nullopt;
+    return options;
+}
+//---------------------------------------------------------------------------
+/// Derives a C identifier from the file name
+string symbol_name(const filesystem::path& input) {
+    string name = input.stem().string();
+    for (char& c : name) {
+        if (!isalnum(static_cast<unsigned char>(c))) c = '_';
+    }
+    if (name.empty() || isdigit(static_cast<unsigned char>(name[0]))) name.insert(name.begin(), '_');
+    return name;
+}
+//---------------------------------------------------------------------------
+compilation_result compile(const filesystem::path& input, const driver_options& options) {
+    compilation_result result;
+    result.symbol = symbol_name(input);
+    auto phase_start = chrono::steady_clock::now();
+    auto end_phase = [&](phase finished) {
+        const auto now = chrono::steady_clock::now();
+        result.phase_times[finished] += now - phase_start;
+        phase_start = now;
+    };
+
+    ifstream file(input);
+    if (!file) {
+        cerr << "Error: Could not read " << input << endl;
+        return result;
+    }
+    stringstream content;
+    content << file.rdbuf();
+    source_management::SourceCode code(content.str());
+    end_phase(READ);
+
+    lexer::lexer lexer(code);
+    parser::parser parser(lexer);
+    auto parse_tree = parser.parse_function_definition();
+    end_phase(PARSE);
+    if (!parse_tree) {
+        cerr << "Error: Could not compile " << input << endl;
+        return result;
+    }
+
+    auto ast = semantic_analysis::ASTCreator::CreateAST(*parse_tree);
+    end_phase(SEMANTIC_ANALYSIS);
+    if (!ast) {
+        cerr << "Error: Could not compile " << input << endl;
+        return result;
+    }
+
+    optimization::pass_manager passes(options.optimization);
+    passes.run(ast);
+    end_phase(OPTIMIZATION);
+
+    if (options.format == output_format::OBJECT) {
+        result.native_code = codegen::x86_64::code_generator::generate(*ast);
+    } else {
+        result.bytecode = persistence::snapshot_image::prepare(*ast);
+    }
+    end_phase(CODE_GENERATION);
+    result.success = true;
+    return result;
+}
+//---------------------------------------------------------------------------
+bool write_file(const filesystem::path& path, const vector<uint8_t>& content) {
+    ofstream file(path, ios::binary | ios::trunc);
+    file.write(reinterpret_cast<const char*>(content.data()), static_cast<streamsize>(content.size()));
+    if (!file) {
+        cerr << "Error: Could not write " << path << endl;
+        return false;
+    }
+    return true;
+}
+//---------------------------------------------------------------------------
+void print_report(const vector<compilation_result>& results, chrono::nanoseconds emission_time, chrono::nanoseconds wall_time, unsigned threads) {
+    chrono::nanoseconds totals[NUMBER_OF_PHASES]{};
+    for (const auto& result : results) {
+        for (unsigned i = 0; i < NUMBER_OF_PHASES; ++i) totals[i] += result.phase_times[i];
+    }
+    auto milliseconds = [](chrono::nanoseconds time) { return chrono::duration<double, milli>(time).count(); };
+    cout << "Compiled " << results.size() << " file(s) on " << threads << " thread(s)\n";
+    cout << left << setw(20) << "phase" << right << setw(14) << "time [ms]" << '\n' << fixed << setprecision(3);
+    for (unsigned i = 0; i < NUMBER_OF_PHASES; ++i) {
+        cout << left << setw(20) << phase_names[i] << right << setw(14) << milliseconds(totals[i]) << '\n';
+    }
+    cout << left << setw(20) << "emission" << right << setw(14) << milliseconds(emission_time) << '\n';
+    // Phases are summed over all threads, wall time is not
+    cout << left << setw(20) << "wall time" << right << setw(14) << milliseconds(wall_time) << endl;
+}
+//---------------------------------------------------------------------------
+} // namespace
+//---------------------------------------------------------------------------
+int main(int argc, char* argv[]) {
+    auto options = parse_arguments(argc, argv);
+    if (!options) {
+        print_usage();
+        return 1;
+    }
+    const auto start = chrono::steady_clock::now();
+
+    // Files are compiled independently, workers pick the next one until all are done
+    const unsigned threads = min<size_t>(options->threads ? options->threads : max(1u, thread::hardware_concurrency()), options->inputs.size());
+    vector<compilation_result> results(options->inputs.size());
+    atomic<size_t> next_input{0};
+    vector<thread> workers;
+    for (unsigned i = 0; i < threads; ++i) {
+        workers.emplace_back([&] {
+            for (size_t input = next_input++; input < results.size(); input = next_input++) {
+                results[input] = compile(options->inputs[input], *options);
+            }
+        });
+    }
+    for (auto& worker : workers) worker.join();
+
+    if (!all_of(results.begin(), results.end(), [](const auto& result) { return result.success; })) return 1;
+
+    const auto emission_start = chrono::steady_clock::now();
+    bool written;
+    if (options->format == output_format::OBJECT) {
+        codegen::elf::object_writer writer;
+        for (size_t i = 0; i < results.size(); ++i) {
+            if (any_of(results.begin(), results.begin() + i, [&](const auto& other) { return other.symbol == results[i].symbol; })) {
+                cerr << "Error: Duplicate function name " << results[i].symbol << endl;
+                return 1;
+            }
+            writer.add_function(results[i].symbol, results[i].native_code);
+        }
+        written = write_file(options->output, writer.finalize());
+    } else {
+        vector<optional<persistence::image_function>> programs;
+        for (auto& result : results) programs.push_back(move(result.bytecode));
+        written = persistence::snapshot_image::write(options->output, persistence::snapshot_image::build(programs));
+    }
+    if (!written) return 1;
+    const auto end = chrono::steady_clock::now();
+
+    print_report(results, end - emission_start, end - start, threads);
+    return 0;
 }
 //---------------------------------------------------------------------------
@@ -0,0 +1,27 @@
+#include "expression_properties.hpp"
+#include "pljit/semantic_analysis/AST.hpp"
+
+using namespace pljit::semantic_analysis;
+
+namespace pljit::optimization {
+
+bool may_fail(const ExpressionNode& node) {
+    switch (node.getType()) {
+        case ASTNode::UnaryOperation: {
+            return may_fail(static_cast<const UnaryOperatorASTNode&>(node).getInput());
+        }
+        case ASTNode::BinaryOperation: {
+            const auto& binary = static_cast<const BinaryOperatorASTNode&>(node);
+            if (binary.get_operator() == BinaryOperatorASTNode::OperatorType::DIVIDE) {
+                const auto& divisor = binary.getRight();
+                if (divisor.getType() != ASTNode::Literal || static_cast<const LiteralNode&>(divisor).get_value() == 0) return true;
+            }
+            return may_fail(binary.getLeft()) || may_fail(binary.getRight());
+        }
+        default: {
+            return false;
+        }
+    }
+}
+
+} // namespace pljit::optimization
@@ -0,0 +1,14 @@
+#ifndef PLJIT_EXPRESSION_PROPERTIES_HPP
+#define PLJIT_EXPRESSION_PROPERTIES_HPP
+
+#include <pljit/semantic_analysis/ast_fwd.hpp>
+
+namespace pljit::optimization {
+
+/// Whether evaluating the expression can fail, i.e. it divides by something that is not a non-zero literal.
+/// Expressions have no other side effects, so those that cannot fail may be dropped.
+bool may_fail(const semantic_analysis::ExpressionNode& node);
+
+} // namespace pljit::optimization
+
+#endif //PLJIT_EXPRESSION_PROPERTIES_HPP
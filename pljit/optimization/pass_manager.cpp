@@ -0,0 +1,148 @@
+#include "pass_manager.hpp"
+#include "pljit/optimization/passes/UnaryPlusRemoval.hpp"
+#include "pljit/optimization/passes/algebraic_simplification.hpp"
+#include "pljit/optimization/passes/constant_propagation.hpp"
+#include "pljit/optimization/passes/dead_code_elimination.hpp"
+#include "pljit/optimization/passes/dead_store_elimination.hpp"
+#include "pljit/optimization/passes/reassociation.hpp"
+#include "pljit/optimization/passes/ssa_optimization.hpp"
+#include "pljit/semantic_analysis/AST.hpp"
+#include "pljit/semantic_analysis/ast_visitor.hpp"
+#include <iomanip>
+#include <ostream>
+
+using namespace pljit::semantic_analysis;
+
+namespace pljit::optimization {
+
+namespace {
+/// Summarizes an AST, the hash changes with (almost) every modification of the tree
+class ast_fingerprint : public ast_visitor {
+    public:
+    unsigned expressions = 0;
+    unsigned statements = 0;
+    std::size_t hash = 0;
+
+    private:
+    void combine(std::size_t value) {
+        hash ^= value + 0x9e3779b97f4a7c15 + (hash << 6) + (hash >> 2);
+    }
+
+    public:
+    void visit(FunctionNode& node) override {
+        for (unsigned i = 0; i < node.get_number_of_statements(); ++i) {
+            node.get_statement(i)->accept(*this);
+        }
+    }
+    void visit(IdentifierNode& node) override {
+        ++expressions;
+        combine(ASTNode::Identifier);
+        combine(node.get_symbol_handle());
+    }
+    void visit(LiteralNode& node) override {
+        ++expressions;
+        combine(ASTNode::Literal);
+        combine(static_cast<std::size_t>(node.get_value()));
+    }
+    void visit(ReturnStatementNode& node) override {
+        ++statements;
+        combine(ASTNode::ReturnStatement);
+        node.get_expression().accept(*this);
+    }
+    void visit(AssignmentNode& node) override {
+        ++statements;
+        combine(ASTNode::Assignment);
+        combine(node.get_identifier().get_symbol_handle());
+        node.get_expression().accept(*this);
+    }
+    void visit(UnaryOperatorASTNode& node) override {
+        ++expressions;
+        combine(ASTNode::UnaryOperation);
+        combine(static_cast<std::size_t>(node.get_operator()));
+        node.getInput().accept(*this);
+    }
+    void visit(BinaryOperatorASTNode& node) override {
+        ++expressions;
+        combine(ASTNode::BinaryOperation);
+        combine(static_cast<std::size_t>(node.get_operator()));
+        node.getLeft().accept(*this);
+        node.getRight().accept(*this);
+    }
+};
+
+ast_fingerprint fingerprint(FunctionNode& ast) {
+    ast_fingerprint result;
+    ast.accept(result);
+    return result;
+}
+} // namespace
+
+pass_manager::pass_manager(optimization_level level) {
+    if (level == optimization_level::O0) return;
+    add_pass<passes::UnaryPlusRemoval>("unary_plus_removal");
+    if (level == optimization_level::O1) {
+        add_pass<passes::constant_propagation>("constant_propagation");
+        add_pass<passes::reassociation>("reassociation");
+        add_pass<passes::algebraic_simplification>("algebraic_simplification");
+        add_pass<passes::dead_code_elimination>("dead_code_elimination");
+        add_pass<passes::dead_store_elimination>("dead_store_elimination");
+        return;
+    }
+    // Constant propagation, common subexpressions and dead code are handled on SSA form. Introduces variables
+    // for shared values, which only pays off for functions that run often.
+    add_pass<passes::ssa_optimization>("ssa_optimization");
+    add_pass<passes::reassociation>("reassociation");
+    add_pass<passes::algebraic_simplification>("algebraic_simplification");
+    set_fixpoint(true);
+}
+
+void pass_manager::set_fixpoint(bool enabled, unsigned max_iterations) {
+    run_to_fixpoint = enabled;
+    this->max_iterations = max_iterations;
+}
+
+unsigned pass_manager::run(std::unique_ptr<FunctionNode>& ast) {
+    const unsigned iterations = run_to_fixpoint ? max_iterations : 1;
+    auto before_pipeline = fingerprint(*ast);
+    for (unsigned iteration = 1; iteration <= iterations; ++iteration) {
+        auto before_pass = before_pipeline;
+        for (unsigned i = 0; i < passes.size(); ++i) {
+            const auto start = std::chrono::steady_clock::now();
+            passes[i]()->optimize_ast(ast);
+            auto& pass_statistics = statistics[i];
+            pass_statistics.time += std::chrono::steady_clock::now() - start;
+            ++pass_statistics.runs;
+
+            auto after_pass = fingerprint(*ast);
+            if (after_pass.expressions < before_pass.expressions) {
+                pass_statistics.nodes_folded += before_pass.expressions - after_pass.expressions;
+            }
+            if (after_pass.statements < before_pass.statements) {
+                pass_statistics.statements_removed += before_pass.statements - after_pass.statements;
+            }
+            before_pass = after_pass;
+        }
+        if (before_pass.hash == before_pipeline.hash && before_pass.expressions == before_pipeline.expressions &&
+            before_pass.statements == before_pipeline.statements) {
+            return iteration;
+        }
+        before_pipeline = before_pass;
+    }
+    return iterations;
+}
+
+void print_pass_statistics(std::ostream& out, const std::vector<pass_statistics>& statistics) {
+    out << std::left << std::setw(24) << "pass" << std::right << std::setw(6) << "runs" << std::setw(8) << "folded"
+        << std::setw(10) << "removed" << std::setw(12) << "time [us]" << '\n';
+    for (const auto& pass : statistics) {
+        out << std::left << std::setw(24) << pass.name << std::right << std::setw(6) << pass.runs << std::setw(8)
+            << pass.nodes_folded << std::setw(10) << pass.statements_removed << std::setw(12)
+            << std::chrono::duration_cast<std::chrono::microseconds>(pass.time).count() << '\n';
+    }
+}
+
+void pass_manager::print_statistics(std::ostream& out) const {
+    print_pass_statistics(out, statistics);
+}
+
+} // namespace pljit::optimization
@@ -0,0 +1,78 @@
+#ifndef PLJIT_PASS_MANAGER_HPP
+#define PLJIT_PASS_MANAGER_HPP
+
+#include "pljit/optimization/optimization_pass.hpp"
+#include <chrono>
+#include <functional>
+#include <iosfwd>
+#include <string_view>
+#include <vector>
+
+namespace pljit::optimization {
+
+/// Bumped whenever a pipeline produces different ASTs, persisted optimized ASTs of other versions are stale
+constexpr uint32_t pipeline_version = 2;
+
+/// Selects the passes run on a function before code is generated
+enum class optimization_level {
+    /// No optimization
+    O0,
+    /// Every pass runs once
+    O1,
+    /// Optimizes on SSA form, which also eliminates common subexpressions. Passes are repeated until the AST no longer changes
+    O2
+};
+
+/// Aggregated over all runs of a pass
+struct pass_statistics {
+    std::string_view name;
+    unsigned runs = 0;
+    /// Expression nodes removed from the AST, e.g. by folding them into a literal
+    unsigned nodes_folded = 0;
+    unsigned statements_removed = 0;
+    std::chrono::nanoseconds time{0};
+};
+
+/// One row per pass
+void print_pass_statistics(std::ostream& out, const std::vector<pass_statistics>& statistics);
+
+/**
+ * Runs a pipeline of optimization passes on an AST. Every run uses a fresh pass instance, as passes
+ * keep per-function state.
+ */
+class pass_manager {
+    using pass_factory = std::function<std::unique_ptr<optimization_pass>()>;
+
+    std::vector<pass_factory> passes;
+    std::vector<pass_statistics> statistics;
+    bool run_to_fixpoint = false;
+    unsigned max_iterations = 16;
+
+    public:
+    pass_manager() = default;
+    /// Creates the pipeline of the given level
+    explicit pass_manager(optimization_level level);
+
+    template <class Pass>
+    void add_pass(std::string_view name) {
+        passes.emplace_back([] { return std::make_unique<Pass>(); });
+        statistics.push_back({name});
+    }
+
+    /// Repeat the pipeline until the AST no longer changes, at most max_iterations times
+    void set_fixpoint(bool enabled, unsigned max_iterations = 16);
+
+    /// @return Number of times the pipeline was run
+    unsigned run(std::unique_ptr<semantic_analysis::FunctionNode>& ast);
+
+    /// One entry per pass, in pipeline order
+    const std::vector<pass_statistics>& get_statistics() const {
+        return statistics;
+    }
+
+    void print_statistics(std::ostream& out) const;
+};
+
+} // namespace pljit::optimization
+
+#endif //PLJIT_PASS_MANAGER_HPP
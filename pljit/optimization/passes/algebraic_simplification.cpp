@@ -0,0 +1,144 @@
+#include "algebraic_simplification.hpp"
+#include "pljit/optimization/expression_properties.hpp"
+#include "pljit/semantic_analysis/AST.hpp"
+
+using namespace pljit::semantic_analysis;
+
+namespace pljit::optimization::passes {
+
+namespace {
+
+using ExpressionPtr = std::unique_ptr<ExpressionNode>;
+using BinaryOperator = BinaryOperatorASTNode::OperatorType;
+using UnaryOperator = UnaryOperatorASTNode::OperatorType;
+
+std::optional<int64_t> literal_value(const ExpressionNode& node) {
+    if (node.getType() != ASTNode::Literal) return std::nullopt;
+    return static_cast<const LiteralNode&>(node).get_value();
+}
+
+bool is_negation(const ExpressionNode& node) {
+    return node.getType() == ASTNode::UnaryOperation &&
+        static_cast<const UnaryOperatorASTNode&>(node).get_operator() == UnaryOperator::MINUS;
+}
+
+/// Structural equality, expressions have no side effects so equal trees compute equal values
+bool equal(const ExpressionNode& lhs, const ExpressionNode& rhs) {
+    if (lhs.getType() != rhs.getType()) return false;
+    switch (lhs.getType()) {
+        case ASTNode::Identifier: {
+            return static_cast<const IdentifierNode&>(lhs).get_symbol_handle() == static_cast<const IdentifierNode&>(rhs).get_symbol_handle();
+        }
+        case ASTNode::Literal: {
+            return literal_value(lhs) == literal_value(rhs);
+        }
+        case ASTNode::UnaryOperation: {
+            const auto& left = static_cast<const UnaryOperatorASTNode&>(lhs);
+            const auto& right = static_cast<const UnaryOperatorASTNode&>(rhs);
+            return left.get_operator() == right.get_operator() && equal(left.getInput(), right.getInput());
+        }
+        case ASTNode::BinaryOperation: {
+            const auto& left = static_cast<const BinaryOperatorASTNode&>(lhs);
+            const auto& right = static_cast<const BinaryOperatorASTNode&>(rhs);
+            return left.get_operator() == right.get_operator() && equal(left.getLeft(), right.getLeft()) && equal(left.getRight(), right.getRight());
+        }
+        default: {
+            return false;
+        }
+    }
+}
+
+} // namespace
+
+void algebraic_simplification::optimize(FunctionNode& node) {
+    for (unsigned i = 0; i < node.get_number_of_statements(); ++i) {
+        node.get_statement(i)->optimize(node.get_statement(i), *this);
+    }
+}
+
+ExpressionPtr algebraic_simplification::simplify(std::unique_ptr<UnaryOperatorASTNode> node) {
+    if (node->get_operator() == UnaryOperator::PLUS) return std::move(node->releaseInput());
+    // - -x = x, also for the most negative value as negation wraps around
+    if (is_negation(node->getInput())) return std::move(static_cast<UnaryOperatorASTNode&>(node->getInput()).releaseInput());
+    return node;
+}
+
+ExpressionPtr algebraic_simplification::simplify(std::unique_ptr<BinaryOperatorASTNode> node) {
+    auto negate = [this](ExpressionPtr input) {
+        return simplify(std::make_unique<UnaryOperatorASTNode>(std::move(input), UnaryOperator::MINUS));
+    };
+    auto zero = [](const ExpressionNode& dropped) -> ExpressionPtr {
+        if (may_fail(dropped)) return nullptr;
+        return std::make_unique<LiteralNode>(0);
+    };
+
+    const auto operation = node->get_operator();
+    if ((operation == BinaryOperator::PLUS || operation == BinaryOperator::MULTIPLY) && literal_value(node->getLeft()) && !literal_value(node->getRight())) {
+        std::swap(node->releaseLeft(), node->releaseRight());
+    }
+    auto& left = node->releaseLeft();
+    auto& right = node->releaseRight();
+    const auto constant = literal_value(*right);
+
+    switch (operation) {
+        case BinaryOperator::PLUS: {
+            if (constant == 0) return std::move(left);
+            // x + -y = x - y
+            if (is_negation(*right)) {
+                auto subtrahend = std::move(static_cast<UnaryOperatorASTNode&>(*right).releaseInput());
+                return simplify(std::make_unique<BinaryOperatorASTNode>(std::move(left), BinaryOperator::MINUS, std::move(subtrahend)));
+            }
+            break;
+        }
+        case BinaryOperator::MINUS: {
+            if (constant == 0) return std::move(left);
+            if (literal_value(*left) == 0) return negate(std::move(right));
+            if (equal(*left, *right)) {
+                if (auto result = zero(*left)) return result;
+            }
+            // x - -y = x + y
+            if (is_negation(*right)) {
+                auto summand = std::move(static_cast<UnaryOperatorASTNode&>(*right).releaseInput());
+                return std::make_unique<BinaryOperatorASTNode>(std::move(left), BinaryOperator::PLUS, std::move(summand));
+            }
+            break;
+        }
+        case BinaryOperator::MULTIPLY: {
+            if (constant == 1) return std::move(left);
+            if (constant == -1) return negate(std::move(left));
+            if (constant == 0) {
+                if (auto result = zero(*left)) return result;
+            }
+            break;
+        }
+        case BinaryOperator::DIVIDE: {
+            if (constant == 1) return std::move(left);
+            if (constant == -1) return negate(std::move(left));
+            break;
+        }
+    }
+    return node;
+}
+
+ExpressionPtr algebraic_simplification::optimize(std::unique_ptr<UnaryOperatorASTNode> node) {
+    node->getInput().optimize(node->releaseInput(), *this);
+    return simplify(std::move(node));
+}
+
+ExpressionPtr algebraic_simplification::optimize(std::unique_ptr<BinaryOperatorASTNode> node) {
+    node->getLeft().optimize(node->releaseLeft(), *this);
+    node->getRight().optimize(node->releaseRight(), *this);
+    return simplify(std::move(node));
+}
+
+std::unique_ptr<StatementNode> algebraic_simplification::optimize(std::unique_ptr<ReturnStatementNode> node) {
+    node->get_expression().optimize(node->releaseExpression(), *this);
+    return node;
+}
+
+std::unique_ptr<StatementNode> algebraic_simplification::optimize(std::unique_ptr<AssignmentNode> node) {
+    node->get_expression().optimize(node->releaseExpression(), *this);
+    return node;
+}
+
+} // namespace pljit::optimization::passes
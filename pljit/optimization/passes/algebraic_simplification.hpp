@@ -0,0 +1,32 @@
+#ifndef PLJIT_ALGEBRAIC_SIMPLIFICATION_HPP
+#define PLJIT_ALGEBRAIC_SIMPLIFICATION_HPP
+
+#include "pljit/optimization/optimization_pass.hpp"
+
+namespace pljit::optimization::passes {
+
+/**
+ * Rewrites algebraic identities bottom up, e.g. x * 1, x + 0, x - x, x * 0, - -x, x - -y and x / -1.
+ * Arithmetic wraps around, so all rewrites hold for every value of x. Operands are only dropped when
+ * evaluating them cannot fail, i.e. they contain no division by a possibly zero divisor.
+ *
+ * Literal operands of commutative operators are moved to the right, where the code generator
+ * strength reduces multiplications and divisions by constants.
+ */
+class algebraic_simplification : public optimization_pass {
+    void optimize(semantic_analysis::FunctionNode& node) override;
+
+    /// Simplifies node, whose children are simplified already
+    std::unique_ptr<semantic_analysis::ExpressionNode> simplify(std::unique_ptr<semantic_analysis::UnaryOperatorASTNode> node);
+    std::unique_ptr<semantic_analysis::ExpressionNode> simplify(std::unique_ptr<semantic_analysis::BinaryOperatorASTNode> node);
+
+    public:
+    std::unique_ptr<semantic_analysis::ExpressionNode> optimize(std::unique_ptr<semantic_analysis::UnaryOperatorASTNode> node) override;
+    std::unique_ptr<semantic_analysis::ExpressionNode> optimize(std::unique_ptr<semantic_analysis::BinaryOperatorASTNode> node) override;
+    std::unique_ptr<semantic_analysis::StatementNode> optimize(std::unique_ptr<semantic_analysis::ReturnStatementNode> node) override;
+    std::unique_ptr<semantic_analysis::StatementNode> optimize(std::unique_ptr<semantic_analysis::AssignmentNode> node) override;
+};
+
+} // namespace pljit::optimization::passes
+
+#endif //PLJIT_ALGEBRAIC_SIMPLIFICATION_HPP
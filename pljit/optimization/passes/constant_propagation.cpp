@@ -76,6 +76,9 @@ std::unique_ptr<pljit::semantic_analysis::StatementNode> pljit::optimization::pa
         node->releaseExpression() = replace_expression(std::move(node->releaseExpression()));
         // Update the value
         constant_variables[node->get_identifier().get_symbol_handle()] = static_cast<LiteralNode&>(node->get_expression()).get_value();
+    } else {
+        // The target is no longer known to be constant
+        constant_variables[node->get_identifier().get_symbol_handle()] = std::nullopt;
     }
     return node;
 }
@@ -14,7 +14,7 @@ void dead_code_elimination::optimize(pljit::semantic_analysis::FunctionNode& nod
     }
 
     while (i < node.get_number_of_statements()) {
-        node.removeStatement(node.get_number_of_statements());
+        node.removeStatement(node.get_number_of_statements() - 1);
     }
 }
 
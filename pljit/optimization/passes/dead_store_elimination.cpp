@@ -0,0 +1,83 @@
+#include "dead_store_elimination.hpp"
+#include "pljit/optimization/expression_properties.hpp"
+#include "pljit/semantic_analysis/AST.hpp"
+#include "pljit/semantic_analysis/ast_visitor.hpp"
+#include <algorithm>
+#include <vector>
+
+using namespace pljit::semantic_analysis;
+
+namespace pljit::optimization::passes {
+
+namespace {
+
+/// Marks every symbol an expression reads
+class read_collector : public ast_visitor {
+    std::vector<bool>& symbols;
+
+    public:
+    explicit read_collector(std::vector<bool>& symbols) : symbols(symbols) {}
+
+    void visit(FunctionNode&) override {}
+    void visit(IdentifierNode& node) override {
+        symbols[node.get_symbol_handle()] = true;
+    }
+    void visit(LiteralNode&) override {}
+    void visit(ReturnStatementNode& node) override {
+        node.get_expression().accept(*this);
+    }
+    void visit(AssignmentNode& node) override {
+        node.get_expression().accept(*this);
+    }
+    void visit(UnaryOperatorASTNode& node) override {
+        node.getInput().accept(*this);
+    }
+    void visit(BinaryOperatorASTNode& node) override {
+        node.getLeft().accept(*this);
+        node.getRight().accept(*this);
+    }
+};
+
+} // namespace
+
+void dead_store_elimination::optimize(FunctionNode& node) {
+    auto& symbols = node.getSymbolTable();
+    // Statements after the first return are never executed, dead_code_elimination removes them
+    unsigned end = 0;
+    while (end < node.get_number_of_statements() && node.get_statement(end)->getType() != ASTNode::ReturnStatement) ++end;
+    if (end < node.get_number_of_statements()) ++end;
+
+    // Nothing is live after the function returned, parameters are passed by value
+    std::vector<bool> live(symbols.size(), false);
+    read_collector reads(live);
+    for (unsigned i = end; i-- > 0;) {
+        auto& statement = *node.get_statement(i);
+        if (statement.getType() == ASTNode::Assignment) {
+            auto& assignment = static_cast<AssignmentNode&>(statement);
+            const auto target = assignment.get_identifier().get_symbol_handle();
+            if (!live[target]) {
+                if (!may_fail(assignment.get_expression())) {
+                    node.removeStatement(i);
+                    continue;
+                }
+            }
+            live[target] = false;
+        }
+        statement.accept(reads);
+    }
+
+    // Remove the symbols that are neither read nor written anymore
+    std::vector<bool> used(symbols.size(), false);
+    read_collector uses(used);
+    for (unsigned i = 0; i < node.get_number_of_statements(); ++i) {
+        auto& statement = *node.get_statement(i);
+        if (statement.getType() == ASTNode::Assignment) {
+            used[static_cast<AssignmentNode&>(statement).get_identifier().get_symbol_handle()] = true;
+        }
+        statement.accept(uses);
+    }
+    if (std::find(used.begin() + static_cast<std::ptrdiff_t>(symbols.get_number_of_parameters()), used.end(), false) == used.end()) return;
+    node.remap_symbols(symbols.remove_unused(used));
+}
+
+} // namespace pljit::optimization::passes
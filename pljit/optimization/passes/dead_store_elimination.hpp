@@ -0,0 +1,23 @@
+#ifndef PLJIT_DEAD_STORE_ELIMINATION_HPP
+#define PLJIT_DEAD_STORE_ELIMINATION_HPP
+
+#include "pljit/optimization/optimization_pass.hpp"
+
+namespace pljit::optimization::passes {
+
+/**
+ * Liveness analysis over the statement list. Functions are straight-line code, so one backward walk from the
+ * first return statement computes which symbols are read later on. Assignments to a symbol that is not live
+ * are removed unless evaluating their value can fail. Statements after the return are left to
+ * dead_code_elimination.
+ *
+ * Variables and constants that are no longer referenced afterwards are removed from the symbol table, which
+ * shrinks the frame of the generated code.
+ */
+class dead_store_elimination : public optimization_pass {
+    void optimize(semantic_analysis::FunctionNode& node) override;
+};
+
+} // namespace pljit::optimization::passes
+
+#endif //PLJIT_DEAD_STORE_ELIMINATION_HPP
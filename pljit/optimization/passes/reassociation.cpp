@@ -0,0 +1,90 @@
+#include "reassociation.hpp"
+#include "pljit/execution/arithmetic.hpp"
+
+using namespace pljit::semantic_analysis;
+
+namespace pljit::optimization::passes {
+
+namespace {
+
+using BinaryOperator = BinaryOperatorASTNode::OperatorType;
+
+bool is_operation(const ExpressionNode& node, BinaryOperator operation) {
+    return node.getType() == ASTNode::BinaryOperation && static_cast<const BinaryOperatorASTNode&>(node).get_operator() == operation;
+}
+
+} // namespace
+
+void reassociation::optimize(FunctionNode& node) {
+    for (unsigned i = 0; i < node.get_number_of_statements(); ++i) {
+        node.get_statement(i)->optimize(node.get_statement(i), *this);
+    }
+}
+
+void reassociation::flatten(ExpressionPtr expression, BinaryOperator operation, std::vector<ExpressionPtr>& operands) {
+    if (is_operation(*expression, operation)) {
+        auto& binary = static_cast<BinaryOperatorASTNode&>(*expression);
+        flatten(std::move(binary.releaseLeft()), operation, operands);
+        flatten(std::move(binary.releaseRight()), operation, operands);
+        return;
+    }
+    // Chains of other operators below are rebalanced on their own
+    expression->optimize(expression, *this);
+    operands.push_back(std::move(expression));
+}
+
+auto reassociation::balance(std::vector<ExpressionPtr>& operands, std::size_t begin, std::size_t end, BinaryOperator operation) -> ExpressionPtr {
+    if (end - begin == 1) return std::move(operands[begin]);
+    const auto middle = begin + (end - begin) / 2;
+    auto left = balance(operands, begin, middle, operation);
+    return std::make_unique<BinaryOperatorASTNode>(std::move(left), operation, balance(operands, middle, end, operation));
+}
+
+std::unique_ptr<ExpressionNode> reassociation::optimize(std::unique_ptr<UnaryOperatorASTNode> node) {
+    node->getInput().optimize(node->releaseInput(), *this);
+    return node;
+}
+
+std::unique_ptr<ExpressionNode> reassociation::optimize(std::unique_ptr<BinaryOperatorASTNode> node) {
+    const auto operation = node->get_operator();
+    const bool associative = operation == BinaryOperator::PLUS || operation == BinaryOperator::MULTIPLY;
+    if (!associative || (!is_operation(node->getLeft(), operation) && !is_operation(node->getRight(), operation))) {
+        node->getLeft().optimize(node->releaseLeft(), *this);
+        node->getRight().optimize(node->releaseRight(), *this);
+        return node;
+    }
+
+    std::vector<ExpressionPtr> operands;
+    flatten(std::move(node), operation, operands);
+
+    // Wrap-around arithmetic keeps the folded literal exact
+    const int64_t identity = operation == BinaryOperator::PLUS ? 0 : 1;
+    int64_t constant = identity;
+    std::size_t terms = 0;
+    for (auto& operand : operands) {
+        if (operand->getType() != ASTNode::Literal) {
+            operands[terms++] = std::move(operand);
+            continue;
+        }
+        const auto value = static_cast<LiteralNode&>(*operand).get_value();
+        constant = operation == BinaryOperator::PLUS ? execution::wrapping_add(constant, value) : execution::wrapping_multiply(constant, value);
+    }
+    operands.resize(terms);
+
+    if (terms == 0) return std::make_unique<LiteralNode>(constant);
+    auto result = balance(operands, 0, terms, operation);
+    if (constant == identity) return result;
+    return std::make_unique<BinaryOperatorASTNode>(std::move(result), operation, std::make_unique<LiteralNode>(constant));
+}
+
+std::unique_ptr<StatementNode> reassociation::optimize(std::unique_ptr<ReturnStatementNode> node) {
+    node->get_expression().optimize(node->releaseExpression(), *this);
+    return node;
+}
+
+std::unique_ptr<StatementNode> reassociation::optimize(std::unique_ptr<AssignmentNode> node) {
+    node->get_expression().optimize(node->releaseExpression(), *this);
+    return node;
+}
+
+} // namespace pljit::optimization::passes
@@ -0,0 +1,37 @@
+#ifndef PLJIT_REASSOCIATION_HPP
+#define PLJIT_REASSOCIATION_HPP
+
+#include "pljit/optimization/optimization_pass.hpp"
+#include "pljit/semantic_analysis/AST.hpp"
+#include <vector>
+
+namespace pljit::optimization::passes {
+
+/**
+ * Rebalances chains of additions and multiplications. The parser builds such chains as degenerate trees, so
+ * every operation waits for the previous one. A balanced tree of n operands only has a critical path of
+ * log2(n) operations, which pipelined and vectorized engines can overlap.
+ *
+ * Both operators are associative and commutative in wrap-around arithmetic. Literals in a chain are folded
+ * into a single literal, which ends up as the right operand of the chain's root. All other operands keep
+ * their order and are still evaluated, so divisions by zero still fail.
+ */
+class reassociation : public optimization_pass {
+    using ExpressionPtr = std::unique_ptr<semantic_analysis::ExpressionNode>;
+
+    void optimize(semantic_analysis::FunctionNode& node) override;
+
+    /// Appends the operands of the chain of operation rooted in expression, in evaluation order
+    void flatten(ExpressionPtr expression, semantic_analysis::BinaryOperatorASTNode::OperatorType operation, std::vector<ExpressionPtr>& operands);
+    static ExpressionPtr balance(std::vector<ExpressionPtr>& operands, std::size_t begin, std::size_t end, semantic_analysis::BinaryOperatorASTNode::OperatorType operation);
+
+    public:
+    std::unique_ptr<semantic_analysis::ExpressionNode> optimize(std::unique_ptr<semantic_analysis::UnaryOperatorASTNode> node) override;
+    std::unique_ptr<semantic_analysis::ExpressionNode> optimize(std::unique_ptr<semantic_analysis::BinaryOperatorASTNode> node) override;
+    std::unique_ptr<semantic_analysis::StatementNode> optimize(std::unique_ptr<semantic_analysis::ReturnStatementNode> node) override;
+    std::unique_ptr<semantic_analysis::StatementNode> optimize(std::unique_ptr<semantic_analysis::AssignmentNode> node) override;
+};
+
+} // namespace pljit::optimization::passes
+
+#endif //PLJIT_REASSOCIATION_HPP
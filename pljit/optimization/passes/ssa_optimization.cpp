@@ -0,0 +1,17 @@
+#include "ssa_optimization.hpp"
+#include "pljit/ir/ast_lowering.hpp"
+#include "pljit/ir/ssa_builder.hpp"
+#include "pljit/ir/ssa_passes.hpp"
+#include "pljit/semantic_analysis/AST.hpp"
+
+using namespace pljit::semantic_analysis;
+
+namespace pljit::optimization::passes {
+
+void ssa_optimization::optimize(FunctionNode& node) {
+    auto function = ir::ssa_builder::build(node);
+    ir::optimize(function);
+    node = std::move(*ir::ast_lowering::lower(function, node.getSymbolTable()));
+}
+
+} // namespace pljit::optimization::passes
@@ -0,0 +1,22 @@
+#ifndef PLJIT_SSA_OPTIMIZATION_HPP
+#define PLJIT_SSA_OPTIMIZATION_HPP
+
+#include "pljit/optimization/optimization_pass.hpp"
+
+namespace pljit::optimization::passes {
+
+/**
+ * Translates the function into SSA form, runs constant propagation, common subexpression elimination and dead
+ * code elimination on it (see ir/ssa_passes.hpp) and lowers the result back into the AST. Copy propagation
+ * happens while the SSA form is built.
+ *
+ * The lowered function has the same parameters, one variable per value that is used several times and no
+ * constants.
+ */
+class ssa_optimization : public optimization_pass {
+    void optimize(semantic_analysis::FunctionNode& node) override;
+};
+
+} // namespace pljit::optimization::passes
+
+#endif //PLJIT_SSA_OPTIMIZATION_HPP
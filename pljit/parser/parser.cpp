@@ -1,4 +1,5 @@
 #include "parser.hpp"
+#include "pljit/source_management/diagnostics.hpp"
 
 using namespace pljit::parser;
 
@@ -313,12 +314,12 @@ void parser::report_error(std::string_view message, std::optional<source_managem
     if (has_error()) return;
     error_flag = true;
     if (position) {
-        std::cerr << message << ": " << *position << std::endl;
+        source_management::diagnostics() << message << ": " << *position << std::endl;
         return;
     } else if (peek_token()) {
-        std::cerr << message << ": " << peek_token()->get_code_reference() << std::endl;
+        source_management::diagnostics() << message << ": " << peek_token()->get_code_reference() << std::endl;
     } else {
-        std::cerr << message << std::endl;
+        source_management::diagnostics() << message << std::endl;
     }
 }
 bool parser::expect_token(parser::TokenType expected_type) const {
@@ -0,0 +1,199 @@
+#include "ast_serializer.hpp"
+#include "pljit/semantic_analysis/AST.hpp"
+#include <cstring>
+#include <optional>
+
+using namespace pljit::semantic_analysis;
+
+namespace pljit::persistence {
+
+namespace {
+enum class node_tag : uint8_t {
+    ASSIGNMENT,
+    RETURN,
+    IDENTIFIER,
+    LITERAL,
+    UNARY,
+    BINARY
+};
+
+/// Bounds checked reading of the encoded AST, every failure poisons the reader
+class reader {
+    const uint8_t* data;
+    std::size_t size;
+    std::size_t offset = 0;
+    bool failed = false;
+
+    public:
+    reader(const uint8_t* data, std::size_t size) : data(data), size(size) {}
+
+    template <class T>
+    std::optional<T> read() {
+        if (failed || size - offset < sizeof(T)) {
+            failed = true;
+            return std::nullopt;
+        }
+        T value;
+        std::memcpy(&value, data + offset, sizeof(T));
+        offset += sizeof(T);
+        return value;
+    }
+
+    bool at_end() const {
+        return !failed && offset == size;
+    }
+};
+
+std::unique_ptr<ExpressionNode> read_expression(reader& input, const symbol_table& symbols) {
+    auto tag = input.read<uint8_t>();
+    if (!tag) return nullptr;
+    switch (static_cast<node_tag>(*tag)) {
+        case node_tag::IDENTIFIER: {
+            auto handle = input.read<uint32_t>();
+            if (!handle || *handle >= symbols.size()) return nullptr;
+            return std::make_unique<IdentifierNode>(*handle);
+        }
+        case node_tag::LITERAL: {
+            auto value = input.read<int64_t>();
+            if (!value) return nullptr;
+            return std::make_unique<LiteralNode>(*value);
+        }
+        case node_tag::UNARY: {
+            auto operation = input.read<uint8_t>();
+            if (!operation || *operation > static_cast<uint8_t>(UnaryOperatorASTNode::OperatorType::MINUS)) return nullptr;
+            auto child = read_expression(input, symbols);
+            if (!child) return nullptr;
+            return std::make_unique<UnaryOperatorASTNode>(std::move(child), static_cast<UnaryOperatorASTNode::OperatorType>(*operation));
+        }
+        case node_tag::BINARY: {
+            auto operation = input.read<uint8_t>();
+            if (!operation || *operation > static_cast<uint8_t>(BinaryOperatorASTNode::OperatorType::DIVIDE)) return nullptr;
+            auto left = read_expression(input, symbols);
+            if (!left) return nullptr;
+            auto right = read_expression(input, symbols);
+            if (!right) return nullptr;
+            return std::make_unique<BinaryOperatorASTNode>(std::move(left), static_cast<BinaryOperatorASTNode::OperatorType>(*operation), std::move(right));
+        }
+        default: return nullptr;
+    }
+}
+} // namespace
+
+uint64_t fnv1a(const void* data, std::size_t size, uint64_t hash) {
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    for (std::size_t i = 0; i < size; ++i) {
+        hash ^= bytes[i];
+        hash *= 0x100000001b3;
+    }
+    return hash;
+}
+
+template <class T>
+void ast_serializer::write(T value) {
+    const auto* bytes = reinterpret_cast<const uint8_t*>(&value);
+    output.insert(output.end(), bytes, bytes + sizeof(T));
+}
+
+void ast_serializer::visit(FunctionNode& node) {
+    const auto& symbols = node.getSymbolTable();
+    write(static_cast<uint32_t>(symbols.size()));
+    for (unsigned i = 0; i < symbols.size(); ++i) {
+        write(static_cast<uint8_t>(symbols.get(i).type));
+        write(symbols.get(i).constant_value);
+    }
+    write(static_cast<uint32_t>(node.get_number_of_statements()));
+    for (unsigned i = 0; i < node.get_number_of_statements(); ++i) {
+        node.get_statement(i)->accept(*this);
+    }
+}
+
+void ast_serializer::visit(IdentifierNode& node) {
+    write(node_tag::IDENTIFIER);
+    write(static_cast<uint32_t>(node.get_symbol_handle()));
+}
+
+void ast_serializer::visit(LiteralNode& node) {
+    write(node_tag::LITERAL);
+    write(node.get_value());
+}
+
+void ast_serializer::visit(ReturnStatementNode& node) {
+    write(node_tag::RETURN);
+    node.get_expression().accept(*this);
+}
+
+void ast_serializer::visit(AssignmentNode& node) {
+    write(node_tag::ASSIGNMENT);
+    write(static_cast<uint32_t>(node.get_identifier().get_symbol_handle()));
+    node.get_expression().accept(*this);
+}
+
+void ast_serializer::visit(UnaryOperatorASTNode& node) {
+    write(node_tag::UNARY);
+    write(static_cast<uint8_t>(node.get_operator()));
+    node.getInput().accept(*this);
+}
+
+void ast_serializer::visit(BinaryOperatorASTNode& node) {
+    write(node_tag::BINARY);
+    write(static_cast<uint8_t>(node.get_operator()));
+    node.getLeft().accept(*this);
+    node.getRight().accept(*this);
+}
+
+std::vector<uint8_t> ast_serializer::serialize(FunctionNode& function) {
+    ast_serializer serializer;
+    function.accept(serializer);
+    return std::move(serializer.output);
+}
+
+std::unique_ptr<FunctionNode> ast_serializer::deserialize(const uint8_t* data, std::size_t size) {
+    reader input(data, size);
+
+    symbol_table symbols;
+    auto number_of_symbols = input.read<uint32_t>();
+    if (!number_of_symbols) return nullptr;
+    // Parameters, variables and constants have to stay in that order for the ids to match
+    auto previous_rank = 0;
+    for (uint32_t i = 0; i < *number_of_symbols; ++i) {
+        auto type = input.read<uint8_t>();
+        auto value = input.read<int64_t>();
+        if (!type || !value) return nullptr;
+        int rank;
+        switch (static_cast<symbol::symbol_type>(*type)) {
+            case symbol::PARAMETER: rank = 0; break;
+            case symbol::VARIABLE: rank = 1; break;
+            case symbol::CONSTANT: rank = 2; break;
+            default: return nullptr;
+        }
+        if (rank < previous_rank) return nullptr;
+        previous_rank = rank;
+        auto type_value = static_cast<symbol::symbol_type>(*type);
+        symbols.insert({}, type_value, type_value == symbol::CONSTANT ? std::optional<int64_t>(*value) : std::nullopt);
+    }
+
+    auto number_of_statements = input.read<uint32_t>();
+    if (!number_of_statements) return nullptr;
+    std::vector<std::unique_ptr<StatementNode>> statements;
+    for (uint32_t i = 0; i < *number_of_statements; ++i) {
+        auto tag = input.read<uint8_t>();
+        if (!tag) return nullptr;
+        if (static_cast<node_tag>(*tag) == node_tag::RETURN) {
+            auto expression = read_expression(input, symbols);
+            if (!expression) return nullptr;
+            statements.push_back(std::make_unique<ReturnStatementNode>(std::move(expression)));
+        } else if (static_cast<node_tag>(*tag) == node_tag::ASSIGNMENT) {
+            auto target = input.read<uint32_t>();
+            if (!target || *target >= symbols.size() || symbols.get(*target).type == symbol::CONSTANT) return nullptr;
+            auto expression = read_expression(input, symbols);
+            if (!expression) return nullptr;
+            statements.push_back(std::make_unique<AssignmentNode>(std::make_unique<IdentifierNode>(*target), std::move(expression)));
+        } else {
+            return nullptr;
+        }
+    }
+    if (!input.at_end()) return nullptr;
+    return std::make_unique<FunctionNode>(std::move(statements), std::move(symbols));
+}
+
+} // namespace pljit::persistence
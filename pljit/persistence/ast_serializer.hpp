@@ -0,0 +1,51 @@
+#ifndef PLJIT_AST_SERIALIZER_HPP
+#define PLJIT_AST_SERIALIZER_HPP
+
+#include "pljit/semantic_analysis/ast_visitor.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+namespace pljit::persistence {
+
+/// Bumped whenever the encoding or the meaning of a stored AST changes
+constexpr uint32_t format_version = 2;
+
+/// 64 bit FNV-1a, stable across processes unlike std::hash
+uint64_t fnv1a(const void* data, std::size_t size, uint64_t hash = 0xcbf29ce484222325);
+
+inline uint64_t fnv1a(std::string_view data, uint64_t hash = 0xcbf29ce484222325) {
+    return fnv1a(data.data(), data.size(), hash);
+}
+
+/**
+ * Encodes an analyzed (and possibly optimized) AST with its symbol table in a compact binary form.
+ * Symbols are stored without their declaration, names are only needed to report errors during
+ * semantic analysis.
+ */
+class ast_serializer : public semantic_analysis::ast_visitor {
+    std::vector<uint8_t> output;
+
+    template <class T>
+    void write(T value);
+
+    public:
+    void visit(semantic_analysis::FunctionNode& node) override;
+    void visit(semantic_analysis::IdentifierNode& node) override;
+    void visit(semantic_analysis::LiteralNode& node) override;
+    void visit(semantic_analysis::ReturnStatementNode& node) override;
+    void visit(semantic_analysis::AssignmentNode& node) override;
+    void visit(semantic_analysis::UnaryOperatorASTNode& node) override;
+    void visit(semantic_analysis::BinaryOperatorASTNode& node) override;
+
+    static std::vector<uint8_t> serialize(semantic_analysis::FunctionNode& function);
+
+    /// @return The decoded function or nullptr if data is malformed
+    static std::unique_ptr<semantic_analysis::FunctionNode> deserialize(const uint8_t* data, std::size_t size);
+};
+
+} // namespace pljit::persistence
+
+#endif //PLJIT_AST_SERIALIZER_HPP
@@ -0,0 +1,87 @@
+#include "code_cache.hpp"
+#include "pljit/persistence/ast_serializer.hpp"
+#include "pljit/semantic_analysis/AST.hpp"
+#include <atomic>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <thread>
+
+namespace pljit::persistence {
+
+namespace {
+constexpr uint32_t cache_magic = 0x434a4c50; // "PLJC"
+
+struct entry_header {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t compiler_version;
+    uint64_t key_size;
+    uint64_t payload_size;
+    /// Over key and payload
+    uint64_t checksum;
+};
+} // namespace
+
+code_cache::code_cache(std::filesystem::path directory, uint32_t compiler_version) : directory(std::move(directory)), compiler_version(compiler_version) {
+    std::error_code error;
+    std::filesystem::create_directories(this->directory, error);
+}
+
+std::filesystem::path code_cache::entry_path(std::string_view key) const {
+    std::stringstream name;
+    // Another format or compiler version never even looks at the entry
+    const uint64_t versions = fnv1a(&compiler_version, sizeof(compiler_version), fnv1a(&format_version, sizeof(format_version)));
+    name << std::hex << std::setw(16) << std::setfill('0') << fnv1a(key, versions) << ".ast";
+    return directory / name.str();
+}
+
+std::unique_ptr<semantic_analysis::FunctionNode> code_cache::load(std::string_view key) const {
+    std::ifstream file(entry_path(key), std::ios::binary);
+    if (!file) return nullptr;
+    std::vector<char> content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    entry_header header;
+    if (content.size() < sizeof(header)) return nullptr;
+    std::memcpy(&header, content.data(), sizeof(header));
+    if (header.magic != cache_magic || header.version != format_version || header.compiler_version != compiler_version) return nullptr;
+    if (header.key_size != key.size() || content.size() - sizeof(header) - header.key_size != header.payload_size) return nullptr;
+
+    const char* stored_key = content.data() + sizeof(header);
+    const auto* payload = reinterpret_cast<const uint8_t*>(stored_key + header.key_size);
+    // Different keys with the same hash share a file name
+    if (std::string_view(stored_key, header.key_size) != key) return nullptr;
+    if (fnv1a(payload, header.payload_size, fnv1a(key)) != header.checksum) return nullptr;
+    return ast_serializer::deserialize(payload, header.payload_size);
+}
+
+void code_cache::store(std::string_view key, semantic_analysis::FunctionNode& ast) const {
+    const auto payload = ast_serializer::serialize(ast);
+    entry_header header{cache_magic, format_version, compiler_version, key.size(), payload.size(), fnv1a(payload.data(), payload.size(), fnv1a(key))};
+
+    // Written to a private file first, readers only ever see complete entries
+    static std::atomic<uint64_t> next_temporary{0};
+    auto path = entry_path(key);
+    auto temporary_path = path;
+    temporary_path += "." + std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id())) + "." +
+        std::to_string(next_temporary.fetch_add(1)) + ".tmp";
+    {
+        std::ofstream file(temporary_path, std::ios::binary | std::ios::trunc);
+        if (!file) return;
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(key.data(), static_cast<std::streamsize>(key.size()));
+        file.write(reinterpret_cast<const char*>(payload.data()), static_cast<std::streamsize>(payload.size()));
+        if (!file) {
+            file.close();
+            std::error_code error;
+            std::filesystem::remove(temporary_path, error);
+            return;
+        }
+    }
+    std::error_code error;
+    std::filesystem::rename(temporary_path, path, error);
+    if (error) std::filesystem::remove(temporary_path, error);
+}
+
+} // namespace pljit::persistence
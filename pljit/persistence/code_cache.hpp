@@ -0,0 +1,45 @@
+#ifndef PLJIT_CODE_CACHE_HPP
+#define PLJIT_CODE_CACHE_HPP
+
+#include "pljit/semantic_analysis/ast_fwd.hpp"
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string_view>
+
+namespace pljit::persistence {
+
+/**
+ * Directory of analyzed and optimized ASTs that survives process restarts. Entries are named after a hash
+ * of their key and the compiler version and carry the key, both versions and a checksum, so stale,
+ * colliding or corrupt entries are detected and ignored. Safe to use from several threads and processes
+ * at once.
+ */
+class code_cache {
+    std::filesystem::path directory;
+    uint32_t compiler_version;
+
+    std::filesystem::path entry_path(std::string_view key) const;
+
+    public:
+    /**
+     * Creates directory if it does not exist yet.
+     * @param compiler_version Identifies the compiler that produces the stored ASTs, e.g. its optimization
+     *      pipeline. Entries stored by another compiler version are never loaded.
+     */
+    code_cache(std::filesystem::path directory, uint32_t compiler_version);
+
+    /// @return The cached AST or nullptr if there is no valid entry for key
+    std::unique_ptr<semantic_analysis::FunctionNode> load(std::string_view key) const;
+
+    /// Best effort, failures to write are ignored
+    void store(std::string_view key, semantic_analysis::FunctionNode& ast) const;
+
+    const std::filesystem::path& get_directory() const {
+        return directory;
+    }
+};
+
+} // namespace pljit::persistence
+
+#endif //PLJIT_CODE_CACHE_HPP
@@ -0,0 +1,245 @@
+#include "snapshot_image.hpp"
+#include "pljit/codegen/bytecode/bytecode_function.hpp"
+#include "pljit/codegen/bytecode/bytecode_generator.hpp"
+#include "pljit/execution/compiled_function.hpp"
+#include "pljit/semantic_analysis/AST.hpp"
+#include <atomic>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <utility>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace pljit::persistence {
+
+using namespace image_format;
+using codegen::bytecode::instruction;
+using codegen::bytecode::opcode;
+
+namespace {
+constexpr std::size_t alignment = 8;
+
+std::size_t align(std::size_t offset) {
+    return (offset + alignment - 1) / alignment * alignment;
+}
+
+/// Whether [offset, offset + count * element_size) lies within the image, without overflowing
+bool in_bounds(uint64_t offset, uint64_t count, uint64_t element_size, std::size_t image_size) {
+    if (offset % alignment != 0 || offset > image_size) return false;
+    return count <= (image_size - offset) / element_size;
+}
+
+bool valid_symbol(const symbol_entry& symbol, std::size_t image_size) {
+    if (symbol.name_offset > image_size || symbol.name_size > image_size - symbol.name_offset) return false;
+    return symbol.type == semantic_analysis::symbol::PARAMETER || symbol.type == semantic_analysis::symbol::VARIABLE ||
+        symbol.type == semantic_analysis::symbol::CONSTANT;
+}
+
+bool valid_instruction(const instruction& current, uint32_t number_of_registers) {
+    switch (current.operation) {
+        case opcode::RETURN: return current.lhs < number_of_registers;
+        case opcode::MOVE:
+        case opcode::NEGATE: return current.destination < number_of_registers && current.lhs < number_of_registers;
+        case opcode::ADD:
+        case opcode::SUBTRACT:
+        case opcode::MULTIPLY:
+        case opcode::DIVIDE:
+            return current.destination < number_of_registers && current.lhs < number_of_registers && current.rhs < number_of_registers;
+    }
+    return false;
+}
+} // namespace
+
+codegen::bytecode::program_view snapshot_function::get_program() const {
+    return {reinterpret_cast<const instruction*>(image + entry->instructions_offset), entry->number_of_instructions,
+            reinterpret_cast<const int64_t*>(image + entry->register_template_offset), entry->number_of_registers, entry->number_of_parameters};
+}
+
+snapshot_symbol snapshot_function::get_symbol(std::size_t index) const {
+    assert(index < get_number_of_symbols());
+    const auto& symbol = reinterpret_cast<const symbol_entry*>(image + entry->symbols_offset)[index];
+    const auto type = static_cast<semantic_analysis::symbol::symbol_type>(symbol.type);
+    const auto register_index = static_cast<uint32_t>(index);
+    const int64_t value = type == semantic_analysis::symbol::CONSTANT ? get_program().register_template[register_index] : 0;
+    return {std::string_view(reinterpret_cast<const char*>(image + symbol.name_offset), symbol.name_size), type, register_index, value};
+}
+
+std::optional<int64_t> snapshot_function::call(const int64_t* parameters, int64_t* frame) const {
+    if (entry->failed) return std::nullopt;
+    if (frame) return codegen::bytecode::execute(get_program(), parameters, frame);
+
+    if (entry->number_of_registers <= execution::compiled_function::inline_frame_size) {
+        int64_t inline_frame[execution::compiled_function::inline_frame_size];
+        return codegen::bytecode::execute(get_program(), parameters, inline_frame);
+    }
+    thread_local std::vector<int64_t> large_frame;
+    if (large_frame.size() < entry->number_of_registers) large_frame.resize(entry->number_of_registers);
+    return codegen::bytecode::execute(get_program(), parameters, large_frame.data());
+}
+
+image_function snapshot_image::prepare(semantic_analysis::FunctionNode& function) {
+    image_function result{codegen::bytecode::bytecode_generator::generate(function), {}};
+    const auto& symbols = function.getSymbolTable();
+    result.symbols.reserve(symbols.size());
+    for (semantic_analysis::symbol_table::symbol_handle handle = 0; handle < symbols.size(); ++handle) {
+        const auto& symbol = symbols.get(handle);
+        result.symbols.push_back({std::string(symbol.get_name()), symbol.type});
+    }
+    return result;
+}
+
+std::vector<uint8_t> snapshot_image::build(const std::vector<std::optional<image_function>>& functions) {
+    std::vector<function_entry> entries(functions.size());
+    std::vector<std::vector<symbol_entry>> symbol_entries(functions.size());
+    std::size_t offset = align(sizeof(header) + functions.size() * sizeof(function_entry));
+    for (std::size_t i = 0; i < functions.size(); ++i) {
+        if (!functions[i]) {
+            entries[i] = {0, 0, 0, 0, 0, 0, 0, 1, 0};
+            continue;
+        }
+        const auto& code = functions[i]->code;
+        const auto& symbols = functions[i]->symbols;
+        entries[i].instructions_offset = offset;
+        entries[i].number_of_instructions = static_cast<uint32_t>(code.instructions.size());
+        offset = align(offset + code.instructions.size() * sizeof(instruction));
+        entries[i].register_template_offset = offset;
+        entries[i].number_of_registers = static_cast<uint32_t>(code.register_template.size());
+        offset = align(offset + code.register_template.size() * sizeof(int64_t));
+        entries[i].symbols_offset = offset;
+        entries[i].number_of_symbols = static_cast<uint32_t>(symbols.size());
+        offset += symbols.size() * sizeof(symbol_entry);
+        // Names follow the symbol entries
+        for (const auto& symbol : symbols) {
+            symbol_entries[i].push_back({offset, static_cast<uint32_t>(symbol.name.size()), static_cast<uint32_t>(symbol.type)});
+            offset += symbol.name.size();
+        }
+        offset = align(offset);
+        entries[i].number_of_parameters = code.number_of_parameters;
+        entries[i].failed = 0;
+        entries[i].reserved = 0;
+    }
+
+    std::vector<uint8_t> image(offset, 0);
+    const header image_header{magic, version, offset, static_cast<uint32_t>(functions.size()), 0, sizeof(header)};
+    std::memcpy(image.data(), &image_header, sizeof(header));
+    if (!entries.empty()) std::memcpy(image.data() + sizeof(header), entries.data(), entries.size() * sizeof(function_entry));
+    for (std::size_t i = 0; i < functions.size(); ++i) {
+        if (!functions[i]) continue;
+        const auto& code = functions[i]->code;
+        std::memcpy(image.data() + entries[i].instructions_offset, code.instructions.data(), code.instructions.size() * sizeof(instruction));
+        std::memcpy(image.data() + entries[i].register_template_offset, code.register_template.data(), code.register_template.size() * sizeof(int64_t));
+        if (symbol_entries[i].empty()) continue;
+        std::memcpy(image.data() + entries[i].symbols_offset, symbol_entries[i].data(), symbol_entries[i].size() * sizeof(symbol_entry));
+        for (std::size_t j = 0; j < symbol_entries[i].size(); ++j) {
+            const auto& name = functions[i]->symbols[j].name;
+            std::memcpy(image.data() + symbol_entries[i][j].name_offset, name.data(), name.size());
+        }
+    }
+    return image;
+}
+
+bool snapshot_image::write(const std::filesystem::path& path, const std::vector<uint8_t>& image) {
+    static std::atomic<uint64_t> next_temporary{0};
+    auto temporary_path = path;
+    temporary_path += "." + std::to_string(::getpid()) + "." + std::to_string(next_temporary.fetch_add(1)) + ".tmp";
+    {
+        std::ofstream file(temporary_path, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(image.data()), static_cast<std::streamsize>(image.size()));
+        if (!file) {
+            std::cerr << "Error: Could not write snapshot image " << temporary_path << std::endl;
+            file.close();
+            std::error_code error;
+            std::filesystem::remove(temporary_path, error);
+            return false;
+        }
+    }
+    std::error_code error;
+    std::filesystem::rename(temporary_path, path, error);
+    if (error) {
+        std::cerr << "Error: Could not write snapshot image " << path << std::endl;
+        std::filesystem::remove(temporary_path, error);
+        return false;
+    }
+    return true;
+}
+
+bool snapshot_image::validate(const std::byte* image, std::size_t image_size) {
+    if (image_size < sizeof(header)) return false;
+    header image_header;
+    std::memcpy(&image_header, image, sizeof(header));
+    if (image_header.magic != magic || image_header.version != version || image_header.image_size != image_size) return false;
+    if (!in_bounds(image_header.functions_offset, image_header.number_of_functions, sizeof(function_entry), image_size)) return false;
+
+    const auto* entries = reinterpret_cast<const function_entry*>(image + image_header.functions_offset);
+    for (uint32_t i = 0; i < image_header.number_of_functions; ++i) {
+        const auto& entry = entries[i];
+        if (entry.failed) continue;
+        if (entry.number_of_instructions == 0 || entry.number_of_parameters > entry.number_of_registers) return false;
+        if (!in_bounds(entry.instructions_offset, entry.number_of_instructions, sizeof(instruction), image_size)) return false;
+        if (!in_bounds(entry.register_template_offset, entry.number_of_registers, sizeof(int64_t), image_size)) return false;
+        if (entry.number_of_symbols > entry.number_of_registers) return false;
+        if (!in_bounds(entry.symbols_offset, entry.number_of_symbols, sizeof(symbol_entry), image_size)) return false;
+        const auto* symbols = reinterpret_cast<const symbol_entry*>(image + entry.symbols_offset);
+        for (uint32_t j = 0; j < entry.number_of_symbols; ++j) {
+            if (!valid_symbol(symbols[j], image_size)) return false;
+        }
+
+        const auto* instructions = reinterpret_cast<const instruction*>(image + entry.instructions_offset);
+        for (uint32_t j = 0; j < entry.number_of_instructions; ++j) {
+            if (!valid_instruction(instructions[j], entry.number_of_registers)) return false;
+        }
+        // Execution has to stop before running off the end
+        if (instructions[entry.number_of_instructions - 1].operation != opcode::RETURN) return false;
+    }
+    return true;
+}
+
+std::optional<snapshot_image> snapshot_image::load(const std::filesystem::path& path) {
+    const int file = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (file < 0) {
+        std::cerr << "Error: Could not open snapshot image " << path << std::endl;
+        return std::nullopt;
+    }
+    struct stat file_status {};
+    if (::fstat(file, &file_status) != 0 || file_status.st_size <= 0) {
+        ::close(file);
+        std::cerr << "Error: Invalid snapshot image " << path << std::endl;
+        return std::nullopt;
+    }
+    const auto size = static_cast<std::size_t>(file_status.st_size);
+    void* mapping = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file, 0);
+    // The mapping keeps the file alive
+    ::close(file);
+    if (mapping == MAP_FAILED) {
+        std::cerr << "Error: Could not map snapshot image " << path << std::endl;
+        return std::nullopt;
+    }
+    const auto* image = static_cast<const std::byte*>(mapping);
+    if (!validate(image, size)) {
+        ::munmap(mapping, size);
+        std::cerr << "Error: Invalid snapshot image " << path << std::endl;
+        return std::nullopt;
+    }
+    return snapshot_image(image, size);
+}
+
+snapshot_image::snapshot_image(snapshot_image&& other) noexcept
+    : image(std::exchange(other.image, nullptr)), image_size(std::exchange(other.image_size, 0)) {}
+
+snapshot_image& snapshot_image::operator=(snapshot_image&& other) noexcept {
+    if (this != &other) {
+        if (image) ::munmap(const_cast<std::byte*>(image), image_size);
+        image = std::exchange(other.image, nullptr);
+        image_size = std::exchange(other.image_size, 0);
+    }
+    return *this;
+}
+
+snapshot_image::~snapshot_image() {
+    if (image) ::munmap(const_cast<std::byte*>(image), image_size);
+}
+
+} // namespace pljit::persistence
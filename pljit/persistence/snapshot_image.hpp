@@ -0,0 +1,174 @@
+#ifndef PLJIT_SNAPSHOT_IMAGE_HPP
+#define PLJIT_SNAPSHOT_IMAGE_HPP
+
+#include "pljit/codegen/bytecode/bytecode.hpp"
+#include "pljit/execution/ExecutionContext.hpp"
+#include "pljit/semantic_analysis/ast_fwd.hpp"
+#include "pljit/semantic_analysis/symbol_table.hpp"
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace pljit::persistence {
+
+namespace image_format {
+constexpr uint32_t magic = 0x494a4c50; // "PLJI"
+constexpr uint32_t version = 2;
+
+struct header {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t image_size;
+    uint32_t number_of_functions;
+    uint32_t reserved;
+    /// All offsets are relative to the start of the image
+    uint64_t functions_offset;
+};
+
+struct function_entry {
+    uint64_t instructions_offset;
+    uint64_t register_template_offset;
+    uint64_t symbols_offset;
+    uint32_t number_of_instructions;
+    uint32_t number_of_registers;
+    uint32_t number_of_parameters;
+    /// Symbol i lives in register i
+    uint32_t number_of_symbols;
+    /// Set if the function failed to compile
+    uint32_t failed;
+    uint32_t reserved;
+};
+
+struct symbol_entry {
+    /// Name characters, not null terminated
+    uint64_t name_offset;
+    uint32_t name_size;
+    uint32_t type;
+};
+} // namespace image_format
+
+/// Symbol of a function, as written to an image
+struct image_symbol {
+    /// Empty if the name is not known
+    std::string name;
+    semantic_analysis::symbol::symbol_type type;
+};
+
+/// Function to write to an image
+struct image_function {
+    codegen::bytecode::program code;
+    /// Symbol i lives in register i of code
+    std::vector<image_symbol> symbols;
+};
+
+/// Symbol of a function in a snapshot image, the name points into the mapped image
+struct snapshot_symbol {
+    std::string_view name;
+    semantic_analysis::symbol::symbol_type type;
+    /// Register holding the symbol
+    uint32_t register_index;
+    /// Value of constants, 0 otherwise
+    int64_t value;
+};
+
+class snapshot_image;
+
+/// Function of a snapshot image. A cheap value, it points into the mapped image.
+class snapshot_function {
+    friend snapshot_image;
+    const std::byte* image;
+    const image_format::function_entry* entry;
+
+    snapshot_function(const std::byte* image, const image_format::function_entry* entry) : image(image), entry(entry) {}
+
+    codegen::bytecode::program_view get_program() const;
+
+    public:
+    /// Number of int64_t slots a frame passed to call has to provide
+    std::size_t get_frame_size() const {
+        return entry->number_of_registers;
+    }
+
+    std::size_t get_number_of_parameters() const {
+        return entry->number_of_parameters;
+    }
+
+    std::size_t get_number_of_symbols() const {
+        return entry->number_of_symbols;
+    }
+
+    snapshot_symbol get_symbol(std::size_t index) const;
+
+    /// Allocation free, behaves like Function::call
+    std::optional<int64_t> call(const int64_t* parameters, int64_t* frame = nullptr) const;
+
+    template <class... Args, class = typename std::enable_if_t<std::conjunction_v<std::is_convertible<Args, int64_t>...>>>
+    execution::ExecutionContext operator()(Args... args) const {
+        static_assert(std::conjunction_v<std::is_convertible<Args, int64_t>...>, "PL supports only int64_t parameters.");
+        // One extra slot, arrays of size zero are not allowed
+        const int64_t parameters[sizeof...(Args) + 1] = {std::forward<Args>(args)...};
+        assert(entry->failed || sizeof...(Args) == get_number_of_parameters());
+        execution::ExecutionContext context;
+        context.set_result(call(parameters));
+        return context;
+    }
+};
+
+/**
+ * Position-independent image of compiled functions and their symbol tables, written by Pljit::save_image.
+ * Loading maps the file read-only and validates it in one pass; functions execute straight from the
+ * mapping as bytecode, without deserialization or allocation. Function ids match the ids of the Pljit the
+ * image was saved from.
+ */
+class snapshot_image {
+    const std::byte* image = nullptr;
+    std::size_t image_size = 0;
+
+    snapshot_image(const std::byte* image, std::size_t image_size) : image(image), image_size(image_size) {}
+
+    const image_format::header& get_header() const {
+        return *reinterpret_cast<const image_format::header*>(image);
+    }
+
+    /// Checks bounds, alignment and every instruction, so execution never leaves the image or the frame
+    static bool validate(const std::byte* image, std::size_t image_size);
+
+    public:
+    /// Compiles function to bytecode and collects its symbol table
+    static image_function prepare(semantic_analysis::FunctionNode& function);
+
+    /// One entry per function, std::nullopt for functions that failed to compile
+    static std::vector<uint8_t> build(const std::vector<std::optional<image_function>>& functions);
+
+    /// Writes the image atomically
+    static bool write(const std::filesystem::path& path, const std::vector<uint8_t>& image);
+
+    /// @return The mapped image or std::nullopt if the file cannot be mapped or is no valid image
+    static std::optional<snapshot_image> load(const std::filesystem::path& path);
+
+    snapshot_image(const snapshot_image&) = delete;
+    snapshot_image& operator=(const snapshot_image&) = delete;
+    snapshot_image(snapshot_image&& other) noexcept;
+    snapshot_image& operator=(snapshot_image&& other) noexcept;
+    ~snapshot_image();
+
+    std::size_t size() const {
+        return get_header().number_of_functions;
+    }
+
+    snapshot_function get(std::size_t id) const {
+        assert(id < size());
+        const auto* entries = reinterpret_cast<const image_format::function_entry*>(image + get_header().functions_offset);
+        return snapshot_function(image, entries + id);
+    }
+};
+
+} // namespace pljit::persistence
+
+#endif //PLJIT_SNAPSHOT_IMAGE_HPP
@@ -0,0 +1,68 @@
+#include "runtime_statistics.hpp"
+#include <ostream>
+#include <sstream>
+
+namespace pljit {
+
+namespace {
+std::atomic<unsigned> next_thread_index{0};
+} // namespace
+
+runtime_statistics::shard& runtime_statistics::local_shard(std::array<shard, number_of_shards>& shards) {
+    // Threads are spread round robin, so the first number_of_shards threads never share a shard
+    thread_local const unsigned thread_index = next_thread_index.fetch_add(1, std::memory_order_relaxed);
+    return shards[thread_index % number_of_shards];
+}
+
+function_statistics runtime_statistics::collect(uint32_t function_id) const {
+    function_statistics result;
+    result.function_id = function_id;
+    for (const auto& shard : shards) {
+        result.calls += shard.calls.load(std::memory_order_relaxed);
+        result.failures += shard.failures.load(std::memory_order_relaxed);
+        result.total_latency += std::chrono::nanoseconds(shard.total_latency.load(std::memory_order_relaxed));
+        for (unsigned i = 0; i < result.latency_buckets.size(); ++i) {
+            result.latency_buckets[i] += shard.latency_buckets[i].load(std::memory_order_relaxed);
+        }
+    }
+    return result;
+}
+
+void statistics_snapshot::write_openmetrics(std::ostream& out) const {
+    out << "# TYPE pljit_function_calls counter\n"
+        << "# HELP pljit_function_calls Calls of the function.\n";
+    for (const auto& function : functions) {
+        out << "pljit_function_calls_total{function=\"" << function.function_id << "\"} " << function.calls << '\n';
+    }
+    out << "# TYPE pljit_function_failures counter\n"
+        << "# HELP pljit_function_failures Calls that did not produce a result.\n";
+    for (const auto& function : functions) {
+        out << "pljit_function_failures_total{function=\"" << function.function_id << "\"} " << function.failures << '\n';
+    }
+    out << "# TYPE pljit_function_call_latency_seconds histogram\n"
+        << "# UNIT pljit_function_call_latency_seconds seconds\n"
+        << "# HELP pljit_function_call_latency_seconds Wall time of a call.\n";
+    for (const auto& function : functions) {
+        // Buckets are cumulative in OpenMetrics
+        uint64_t count = 0;
+        for (unsigned i = 0; i < function_statistics::number_of_buckets; ++i) {
+            count += function.latency_buckets[i];
+            out << "pljit_function_call_latency_seconds_bucket{function=\"" << function.function_id << "\",le=\""
+                << std::chrono::duration<double>(function_statistics::bucket_bound(i)).count() << "\"} " << count << '\n';
+        }
+        count += function.latency_buckets[function_statistics::number_of_buckets];
+        out << "pljit_function_call_latency_seconds_bucket{function=\"" << function.function_id << "\",le=\"+Inf\"} " << count << '\n';
+        out << "pljit_function_call_latency_seconds_count{function=\"" << function.function_id << "\"} " << count << '\n';
+        out << "pljit_function_call_latency_seconds_sum{function=\"" << function.function_id << "\"} "
+            << std::chrono::duration<double>(function.total_latency).count() << '\n';
+    }
+    out << "# EOF\n";
+}
+
+std::string statistics_snapshot::to_openmetrics() const {
+    std::ostringstream out;
+    write_openmetrics(out);
+    return out.str();
+}
+
+} // namespace pljit
@@ -0,0 +1,83 @@
+#ifndef PLJIT_RUNTIME_STATISTICS_HPP
+#define PLJIT_RUNTIME_STATISTICS_HPP
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace pljit {
+
+/// Calls of one function, summed over all threads
+struct function_statistics {
+    /// Bucket i counts calls that took at most bucket_bound(i), the last bucket counts all slower ones
+    static constexpr unsigned number_of_buckets = 24;
+
+    uint32_t function_id = 0;
+    uint64_t calls = 0;
+    /// Calls without a result, e.g. division by zero or a failed compilation
+    uint64_t failures = 0;
+    std::chrono::nanoseconds total_latency{0};
+    std::array<uint64_t, number_of_buckets + 1> latency_buckets{};
+
+    /// Inclusive upper latency bound of bucket i < number_of_buckets, like the le label of OpenMetrics
+    static constexpr std::chrono::nanoseconds bucket_bound(unsigned i) {
+        return std::chrono::nanoseconds(int64_t{16} << i);
+    }
+};
+
+/**
+ * Counters of the calls of one function. Every thread updates one of a few cache line aligned shards, so
+ * concurrent callers rarely touch the same cache line.
+ */
+class runtime_statistics {
+    static constexpr unsigned number_of_shards = 8;
+
+    struct alignas(64) shard {
+        std::atomic<uint64_t> calls{0};
+        std::atomic<uint64_t> failures{0};
+        std::atomic<uint64_t> total_latency{0};
+        std::array<std::atomic<uint64_t>, function_statistics::number_of_buckets + 1> latency_buckets{};
+    };
+    std::array<shard, number_of_shards> shards;
+
+    static unsigned bucket(uint64_t nanoseconds) {
+        // Latencies in (2^(k-1), 2^k] land in the bucket bounded by 2^k, everything up to 16ns in the first
+        if (nanoseconds <= 16) return 0;
+        const unsigned width = 64 - __builtin_clzll(nanoseconds - 1);
+        return std::min(width - 4, function_statistics::number_of_buckets);
+    }
+
+    static shard& local_shard(std::array<shard, number_of_shards>& shards);
+
+    public:
+    void record(std::chrono::nanoseconds latency, bool success) {
+        auto& shard = local_shard(shards);
+        const auto nanoseconds = static_cast<uint64_t>(latency.count());
+        // Counters are independent, the snapshot does not need a consistent view of them
+        shard.calls.fetch_add(1, std::memory_order_relaxed);
+        if (!success) shard.failures.fetch_add(1, std::memory_order_relaxed);
+        shard.total_latency.fetch_add(nanoseconds, std::memory_order_relaxed);
+        shard.latency_buckets[bucket(nanoseconds)].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /// Sums up the shards. Calls recorded concurrently may be partially included.
+    function_statistics collect(uint32_t function_id) const;
+};
+
+/// Statistics of all functions that record them
+struct statistics_snapshot {
+    std::vector<function_statistics> functions;
+
+    /// Writes one counter family for calls and failures and one latency histogram, labeled by function id
+    void write_openmetrics(std::ostream& out) const;
+    std::string to_openmetrics() const;
+};
+
+} // namespace pljit
+
+#endif //PLJIT_RUNTIME_STATISTICS_HPP
@@ -2,6 +2,7 @@
 #include "ASTCreator.hpp"
 #include "ast_visitor.hpp"
 #include "pljit/execution/ExecutionContext.hpp"
+#include "pljit/execution/arithmetic.hpp"
 #include "pljit/optimization/optimization_pass.hpp"
 #include "pljit/parser/parse_tree_nodes.hpp"
 
@@ -10,6 +11,37 @@ using namespace pljit;
 
 namespace pljit::semantic_analysis {
 
+namespace {
+
+class handle_remapper : public ast_visitor {
+    const std::vector<symbol_table::symbol_handle>& handles;
+
+    public:
+    explicit handle_remapper(const std::vector<symbol_table::symbol_handle>& handles) : handles(handles) {}
+
+    void visit(FunctionNode&) override {}
+    void visit(IdentifierNode& node) override {
+        node.set_symbol_handle(handles[node.get_symbol_handle()]);
+    }
+    void visit(LiteralNode&) override {}
+    void visit(ReturnStatementNode& node) override {
+        node.get_expression().accept(*this);
+    }
+    void visit(AssignmentNode& node) override {
+        node.get_identifier().accept(*this);
+        node.get_expression().accept(*this);
+    }
+    void visit(UnaryOperatorASTNode& node) override {
+        node.getInput().accept(*this);
+    }
+    void visit(BinaryOperatorASTNode& node) override {
+        node.getLeft().accept(*this);
+        node.getRight().accept(*this);
+    }
+};
+
+} // namespace
+
 void FunctionNode::accept(ast_visitor& visitor) {
     visitor.visit(*this);
 }
@@ -43,6 +75,16 @@ symbol_table& FunctionNode::getSymbolTable() {
 void FunctionNode::removeStatement(unsigned int id) {
     statements.erase(statements.begin() + id);
 }
+void FunctionNode::insertStatement(unsigned int id, std::unique_ptr<StatementNode> statement) {
+    assert(id <= statements.size());
+    statements.insert(statements.begin() + id, std::move(statement));
+}
+void FunctionNode::remap_symbols(const std::vector<symbol_table::symbol_handle>& handles) {
+    handle_remapper remapper(handles);
+    for (auto& statement : statements) {
+        statement->accept(remapper);
+    }
+}
 std::unique_ptr<StatementNode> FunctionNode::releaseStatement(unsigned int id) {
     return std::move(statements[id]);
 }
@@ -62,20 +104,20 @@ std::optional<int64_t> BinaryOperatorASTNode::evaluate(ExecutionContext& context
     if (!rhs_result) return {};
     switch (get_operator()) {
         case semantic_analysis::BinaryOperatorASTNode::OperatorType::PLUS: {
-            return *lhs_result + *rhs_result;
+            return execution::wrapping_add(*lhs_result, *rhs_result);
         }
         case semantic_analysis::BinaryOperatorASTNode::OperatorType::MINUS: {
-            return *lhs_result - *rhs_result;
+            return execution::wrapping_subtract(*lhs_result, *rhs_result);
         }
         case semantic_analysis::BinaryOperatorASTNode::OperatorType::MULTIPLY: {
-            return *lhs_result * *rhs_result;
+            return execution::wrapping_multiply(*lhs_result, *rhs_result);
         }
         case semantic_analysis::BinaryOperatorASTNode::OperatorType::DIVIDE: {
             if (rhs_result == 0) {
-                std::cerr << "Error: Division by zero at " << std::endl;
+                execution::report_division_by_zero();
                 return {};
             }
-            return *lhs_result / *rhs_result;
+            return execution::wrapping_divide(*lhs_result, *rhs_result);
         }
     }
     // Unreachable
@@ -108,7 +150,7 @@ std::optional<int64_t> UnaryOperatorASTNode::evaluate(ExecutionContext& context)
             return result;
         }
         case semantic_analysis::UnaryOperatorASTNode::OperatorType::MINUS: {
-            return -*result;
+            return execution::wrapping_negate(*result);
         }
     }
     // Unreachable
@@ -84,7 +84,14 @@ class FunctionNode : public ASTNode {
 
     void removeStatement(unsigned int id);
 
+    /// Inserts statement in front of statement id, or at the end if id is the number of statements
+    void insertStatement(unsigned int id, std::unique_ptr<StatementNode> statement);
+
     std::unique_ptr<StatementNode> releaseStatement(unsigned int id);
+
+    /// Rewrites every identifier after the symbol table was renumbered, handles maps old to new handles
+    void remap_symbols(const std::vector<symbol_table::symbol_handle>& handles);
+
     void accept(ast_visitor& visitor) override;
     std::optional<int64_t> evaluate(execution::ExecutionContext& context) const override;
 };
@@ -96,6 +103,10 @@ class IdentifierNode : public ExpressionNode {
     explicit IdentifierNode(symbol_table::symbol_handle symbol_handle) : ExpressionNode(ASTNode::Identifier), symbol(symbol_handle){};
 
     symbol_table::symbol_handle get_symbol_handle() const;
+    /// For passes that renumber symbols
+    void set_symbol_handle(symbol_table::symbol_handle symbol_handle) {
+        symbol = symbol_handle;
+    }
 
     public:
     void optimize(std::unique_ptr<ExpressionNode>& self, optimization::optimization_pass& optimizer) override;
@@ -1,6 +1,7 @@
 #include "ASTCreator.hpp"
 #include "pljit/parser/parse_tree_nodes.hpp"
 #include "pljit/semantic_analysis/AST.hpp"
+#include "pljit/source_management/diagnostics.hpp"
 
 using namespace pljit;
 
@@ -20,10 +21,10 @@ auto ASTCreator::register_symbol(const parser::identifier_node& node, symbol::sy
 bool ASTCreator::analyze_declarations(const parser::declarator_list_node& node, symbol::symbol_type symbolType) {
     for (unsigned i = 0; i < node.get_number_of_declarations(); ++i) {
         if (auto [handle, success] = register_symbol(*node.get_declaration(i), symbolType, std::nullopt); !success) {
-            std::cerr << "Error: Redeclaration of identifier \""
+            source_management::diagnostics() << "Error: Redeclaration of identifier \""
                       << node.getCodeReference().str()
                       << "\" originally defined here: ";
-            std::cerr << symbols.get(handle).declaration << std::endl;
+            source_management::diagnostics() << symbols.get(handle).declaration << std::endl;
             return false;
         }
     }
@@ -34,10 +35,10 @@ bool ASTCreator::analyze_declarations(const parser::init_declarator_list_node& n
     for (unsigned i = 0; i < node.get_number_of_declarations(); ++i) {
         const auto* declaration = node.get_declaration(i);
         if (auto [handle, success] = register_symbol(*declaration->get_identifier(), symbolType, declaration->get_value()->get_value()); !success) {
-            std::cerr << "Error: Redeclaration of identifier \""
+            source_management::diagnostics() << "Error: Redeclaration of identifier \""
                       << node.getCodeReference().str()
                       << "\" originally defined here: ";
-            std::cerr << symbols.get(handle).declaration << std::endl;
+            source_management::diagnostics() << symbols.get(handle).declaration << std::endl;
             return false;
         }
     }
@@ -83,7 +84,7 @@ std::unique_ptr<FunctionNode> ASTCreator::analyze_function(const parser::functio
     }
 
     if (!has_return_statement) {
-        std::cerr << "Error: Missing return statement!" << std::endl;
+        source_management::diagnostics() << "Error: Missing return statement!" << std::endl;
         return nullptr;
     }
 
@@ -96,8 +97,8 @@ std::unique_ptr<IdentifierNode> ASTCreator::analyze_identifier(const parser::ide
     if (auto identifier_id = identifier_mapping.find(node.get_name()); identifier_id != identifier_mapping.end()) {
         return std::make_unique<IdentifierNode>(identifier_id->second);
     } else {
-        std::cerr << "Error: Undeclared identifier \"" << node.get_name() << "\"\n";
-        std::cerr << node.get_token().get_code_reference() << std::endl;
+        source_management::diagnostics() << "Error: Undeclared identifier \"" << node.get_name() << "\"\n";
+        source_management::diagnostics() << node.get_token().get_code_reference() << std::endl;
         return nullptr;
     }
 }
@@ -122,8 +123,8 @@ std::unique_ptr<AssignmentNode> ASTCreator::analyze_assignment_node(const parser
     symbol.set_initialized();
 
     if (symbol.type == symbol::CONSTANT) {
-        std::cerr << "Error: Assigning to constant \"" << node.get_identifier()->get_name() << "\" in \n";
-        std::cerr << node.get_identifier()->getCodeReference() << std::endl;
+        source_management::diagnostics() << "Error: Assigning to constant \"" << node.get_identifier()->get_name() << "\" in \n";
+        source_management::diagnostics() << node.get_identifier()->getCodeReference() << std::endl;
         return nullptr;
     }
 
@@ -195,8 +196,8 @@ std::unique_ptr<ExpressionNode> ASTCreator::analyze_expression(const parser::pri
             if (!initializer) return nullptr;
 
             if (!symbols.get(initializer->get_symbol_handle()).initialized) {
-                std::cerr << "Error: Variable \"" << node.get_identifier()->get_name() << "\" has not been initialized but is referenced in \n";
-                std::cerr << node.get_identifier()->get_token().get_code_reference() << std::endl;
+                source_management::diagnostics() << "Error: Variable \"" << node.get_identifier()->get_name() << "\" has not been initialized but is referenced in \n";
+                source_management::diagnostics() << node.get_identifier()->get_token().get_code_reference() << std::endl;
                 return nullptr;
             }
 
@@ -5,6 +5,7 @@
 #include "pljit/parser/parser_fwd.hpp"
 #include "pljit/semantic_analysis/ast_fwd.hpp"
 #include "pljit/semantic_analysis/symbol_table.hpp"
+#include <unordered_map>
 
 //---------------------------------------------------------------------------
 namespace pljit::semantic_analysis {
@@ -14,6 +14,34 @@ auto symbol_table::insert(pljit::source_management::SourceFragment decl, symbol:
     return id;
 }
 
+auto symbol_table::insert_variables(size_type count) -> symbol_handle {
+    const symbol_handle first = number_of_parameters + number_of_variables;
+    symbols.insert(symbols.begin() + first, count, {{}, symbol::VARIABLE, 0, false, 0});
+    for (auto id = first; id < symbols.size(); ++id) {
+        symbols[id].id = id;
+    }
+    number_of_variables += count;
+    return first;
+}
+
+auto symbol_table::remove_unused(const std::vector<bool>& used) -> std::vector<symbol_handle> {
+    std::vector<symbol_handle> handles(symbols.size());
+    std::vector<symbol> kept;
+    number_of_variables = 0;
+    number_of_constants = 0;
+    for (symbol_handle handle = 0; handle < symbols.size(); ++handle) {
+        auto& symbol = symbols[handle];
+        if (symbol.type != symbol::PARAMETER && !used[handle]) continue;
+        if (symbol.type == symbol::VARIABLE) ++number_of_variables;
+        if (symbol.type == symbol::CONSTANT) ++number_of_constants;
+        handles[handle] = kept.size();
+        symbol.id = kept.size();
+        kept.push_back(symbol);
+    }
+    symbols = std::move(kept);
+    return handles;
+}
+
 symbol& symbol_table::get(symbol_table::symbol_handle handle) {
     return symbols[handle];
 }
@@ -62,6 +90,7 @@ int64_t symbol::get_value() const {
     return constant_value;
 }
 std::string_view symbol::get_name() const {
+    if (declaration == source_management::SourceFragment()) return {};
     return declaration.str();
 }
 void symbol::set_initialized() {
@@ -3,6 +3,7 @@
 #define PLJIT_SYMBOL_TABLE_HPP
 
 #include "pljit/source_management/SourceCode.hpp"
+#include <optional>
 #include <string_view>
 
 namespace pljit::semantic_analysis {
@@ -20,6 +21,7 @@ struct symbol {
     bool initialized;
     int64_t constant_value;
 
+    /// Empty for symbols without declaration, e.g. ones introduced by optimizations or read from a cache
     std::string_view get_name() const;
     int64_t get_value() const;
 
@@ -42,6 +44,18 @@ class symbol_table {
     public:
     using symbol_handle = std::vector<symbol>::size_type;
     symbol_handle insert(source_management::SourceFragment decl, symbol::symbol_type type, std::optional<int64_t> initial_value);
+    /**
+     * Adds count variables without declaration, e.g. for temporaries introduced by optimizations. They are
+     * placed in front of the constants to keep the order, so the handles of all constants grow by count.
+     * @return Handle of the first new variable
+     */
+    symbol_handle insert_variables(size_type count);
+    /**
+     * Removes the variables and constants whose entry in used is false. Parameters are always kept, they are
+     * passed by position. The remaining symbols keep their order.
+     * @return The new handle of every kept symbol, indexed by its old handle
+     */
+    std::vector<symbol_handle> remove_unused(const std::vector<bool>& used);
     std::optional<symbol_handle> find(std::string_view name) const;
     symbol& get(symbol_handle handle);
     const symbol& get(symbol_handle handle) const;
@@ -105,6 +105,9 @@ void SourceFragment::extend(const SourceFragment& other) {
 SourcePosition::offset_t SourceCode::line_length(SourcePosition::offset_t line) const {
     return get(line).size();
 }
+SourcePosition::offset_t SourceCode::get_offset(const SourcePosition& position) const {
+    return get_line_offset(position.get_line()) + position.get_cursor();
+}
 SourcePosition::offset_t SourceCode::get_line_offset(SourceCode::offset_t line) const {
     assert(line <= lines.size());
     if (line == 0) {
@@ -13,6 +13,7 @@
 #include <ostream>
 #include <string>
 #include <string_view>
+#include <vector>
 
 namespace pljit::source_management {
 
@@ -134,6 +135,9 @@ class SourceCode {
 
     SourcePosition::offset_t line_length(SourcePosition::offset_t line) const;
 
+    /// Number of characters before position
+    SourcePosition::offset_t get_offset(const SourcePosition& position) const;
+
     private:
     SourcePosition::offset_t get_line_offset(offset_t line) const;
 
@@ -0,0 +1,28 @@
+#include "diagnostics.hpp"
+#include <iostream>
+
+namespace pljit::source_management {
+
+namespace {
+thread_local std::ostream* current_stream = nullptr;
+} // namespace
+
+std::ostream& diagnostics() {
+    return current_stream ? *current_stream : std::cerr;
+}
+
+diagnostics_redirect::diagnostics_redirect(std::ostream& target) : previous(current_stream) {
+    current_stream = &target;
+}
+
+diagnostics_redirect::~diagnostics_redirect() {
+    current_stream = previous;
+}
+
+std::ostream& null_stream() {
+    // A stream without buffer fails every write silently
+    thread_local std::ostream stream(nullptr);
+    return stream;
+}
+
+} // namespace pljit::source_management
@@ -0,0 +1,27 @@
+#ifndef PLJIT_DIAGNOSTICS_HPP
+#define PLJIT_DIAGNOSTICS_HPP
+
+#include <ostream>
+
+namespace pljit::source_management {
+
+/// Stream compilation errors are reported to. std::cerr, unless redirected on the calling thread.
+std::ostream& diagnostics();
+
+/// Redirects diagnostics() of the current thread while it is alive
+class diagnostics_redirect {
+    std::ostream* previous;
+
+    public:
+    explicit diagnostics_redirect(std::ostream& target);
+    diagnostics_redirect(const diagnostics_redirect&) = delete;
+    diagnostics_redirect& operator=(const diagnostics_redirect&) = delete;
+    ~diagnostics_redirect();
+};
+
+/// Discards everything written to it
+std::ostream& null_stream();
+
+} // namespace pljit::source_management
+
+#endif //PLJIT_DIAGNOSTICS_HPP
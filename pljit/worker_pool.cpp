@@ -0,0 +1,108 @@
+#include "worker_pool.hpp"
+#include "pljit/execution/atomic_wait.hpp"
+#include <algorithm>
+#include <memory>
+
+namespace pljit {
+
+worker_pool::worker_pool(unsigned number_of_workers)
+    : number_of_workers(number_of_workers ? number_of_workers : std::max(1u, std::thread::hardware_concurrency())) {}
+
+worker_pool::~worker_pool() {
+    {
+        std::unique_lock lock{mutex};
+        stopping = true;
+        tasks.clear();
+    }
+    wakeups.fetch_add(1, std::memory_order_release);
+    execution::atomic_notify_all(wakeups);
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+void worker_pool::submit(std::function<void()> task) {
+    {
+        std::unique_lock lock{mutex};
+        if (workers.empty()) {
+            workers.reserve(number_of_workers);
+            for (unsigned i = 0; i < number_of_workers; ++i) {
+                workers.emplace_back([this] { work(); });
+            }
+        }
+        tasks.push_back(std::move(task));
+    }
+    wakeups.fetch_add(1, std::memory_order_release);
+    execution::atomic_notify_one(wakeups);
+}
+
+namespace {
+
+struct parallel_loop {
+    const std::function<void(std::size_t)>& body;
+    const std::size_t n;
+    const std::size_t chunk_size;
+    std::atomic<std::size_t> next{0};
+    std::atomic<std::size_t> remaining;
+    /// Set to 1 once remaining dropped to zero
+    std::atomic<uint32_t> done{0};
+
+    parallel_loop(const std::function<void(std::size_t)>& body, std::size_t n, std::size_t chunk_size)
+        : body(body), n(n), chunk_size(chunk_size), remaining(n) {}
+
+    void run() {
+        // body is only touched for claimed indices, i.e. while the caller still waits
+        for (auto begin = next.fetch_add(chunk_size, std::memory_order_relaxed); begin < n; begin = next.fetch_add(chunk_size, std::memory_order_relaxed)) {
+            const auto end = std::min(begin + chunk_size, n);
+            for (auto i = begin; i < end; ++i) body(i);
+            if (remaining.fetch_sub(end - begin, std::memory_order_acq_rel) == end - begin) {
+                done.store(1, std::memory_order_release);
+                execution::atomic_notify_all(done);
+            }
+        }
+    }
+};
+
+} // namespace
+
+void worker_pool::parallel_for(std::size_t n, const std::function<void(std::size_t)>& body) {
+    if (n == 0) return;
+    // Small chunks balance uneven items, large ones keep the shared counter cold
+    const std::size_t chunk_size = std::clamp<std::size_t>(n / (8 * number_of_workers), 1, 64);
+    // Helpers may start after the loop finished, so they share ownership of its state
+    auto loop = std::make_shared<parallel_loop>(body, n, chunk_size);
+    const std::size_t chunks = (n + chunk_size - 1) / chunk_size;
+    const std::size_t helpers = std::min<std::size_t>(number_of_workers, chunks - 1);
+    for (std::size_t i = 0; i < helpers; ++i) {
+        submit([loop] { loop->run(); });
+    }
+    loop->run();
+    while (loop->done.load(std::memory_order_acquire) == 0) {
+        execution::atomic_wait(loop->done, 0);
+    }
+}
+
+void worker_pool::work() {
+    while (true) {
+        std::function<void()> task;
+        uint32_t observed_wakeups;
+        {
+            std::unique_lock lock{mutex};
+            if (stopping) return;
+            if (!tasks.empty()) {
+                task = std::move(tasks.front());
+                tasks.pop_front();
+            } else {
+                // Read under the lock, a later submit is guaranteed to change the value
+                observed_wakeups = wakeups.load(std::memory_order_acquire);
+            }
+        }
+        if (task) {
+            task();
+        } else {
+            execution::atomic_wait(wakeups, observed_wakeups);
+        }
+    }
+}
+
+} // namespace pljit
@@ -0,0 +1,48 @@
+#ifndef PLJIT_WORKER_POOL_HPP
+#define PLJIT_WORKER_POOL_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace pljit {
+
+/**
+ * Fixed number of threads running submitted tasks in FIFO order. The threads are started with the first
+ * task. Tasks that did not start yet are dropped on destruction.
+ */
+class worker_pool {
+    std::mutex mutex;
+    std::deque<std::function<void()>> tasks;
+    std::vector<std::thread> workers;
+    unsigned number_of_workers;
+    bool stopping = false;
+    /// Bumped whenever workers should re-check the queue, idle workers wait on it
+    std::atomic<uint32_t> wakeups{0};
+
+    void work();
+
+    public:
+    /// number_of_workers 0 uses one thread per hardware thread
+    explicit worker_pool(unsigned number_of_workers = 0);
+    worker_pool(const worker_pool&) = delete;
+    worker_pool& operator=(const worker_pool&) = delete;
+    ~worker_pool();
+
+    void submit(std::function<void()> task);
+
+    /**
+     * Runs body(i) for every i in [0, n) on the workers and the calling thread, returns once all are done.
+     * Indices are claimed in small chunks from a shared counter, so threads that finish early take over
+     * the remaining work instead of idling.
+     */
+    void parallel_for(std::size_t n, const std::function<void(std::size_t)>& body);
+};
+
+} // namespace pljit
+
+#endif //PLJIT_WORKER_POOL_HPP
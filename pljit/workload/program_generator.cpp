@@ -0,0 +1,232 @@
+#include "program_generator.hpp"
+#include <limits>
+
+namespace pljit::workload {
+
+namespace {
+
+/// Grammar rule an expression was produced by, decides where it needs parentheses
+enum class expression_kind {
+    /// Identifier, literal or parenthesized expression
+    PRIMARY,
+    NEGATION,
+    MULTIPLICATIVE,
+    ADDITIVE
+};
+
+struct expression {
+    std::string text;
+    expression_kind kind;
+    /// One value per argument vector, std::nullopt if the expression divides by zero
+    std::vector<std::optional<int64_t>> values;
+};
+
+struct symbol {
+    std::string name;
+    /// Constants and parameters are always readable, variables once they were assigned
+    bool readable;
+    std::vector<int64_t> values;
+};
+
+/// Identifiers may only contain letters, the lower case prefix keeps them apart from the keywords
+std::string symbol_name(char prefix, unsigned index) {
+    std::string name(1, prefix);
+    do {
+        name.push_back(static_cast<char>('a' + index % 26));
+        index /= 26;
+    } while (index);
+    return name;
+}
+
+std::string parenthesize(const expression& expression, bool needed) {
+    return needed ? "(" + expression.text + ")" : expression.text;
+}
+
+/// State of one generate() call
+class generation {
+    const generator_options& options;
+    std::mt19937_64& random;
+    std::vector<symbol> symbols;
+    /// Symbols [0, assignable) may be assigned: parameters and variables
+    std::size_t assignable = 0;
+    /// Argument vectors whose execution did not divide by zero so far
+    std::vector<bool> alive;
+
+    bool chance(double probability) {
+        return std::bernoulli_distribution(probability)(random);
+    }
+
+    template <class T>
+    T uniform(T min, T max) {
+        return std::uniform_int_distribution<T>(min, max)(random);
+    }
+
+    expression generate_operand() {
+        std::vector<const symbol*> readable;
+        for (const auto& symbol : symbols) {
+            if (symbol.readable) readable.push_back(&symbol);
+        }
+        if (readable.empty() || chance(0.2)) {
+            const auto value = uniform<int64_t>(0, options.max_literal);
+            return {std::to_string(value), expression_kind::PRIMARY, std::vector<std::optional<int64_t>>(alive.size(), value)};
+        }
+        const auto& symbol = *readable[uniform<std::size_t>(0, readable.size() - 1)];
+        return {symbol.name, expression_kind::PRIMARY, {symbol.values.begin(), symbol.values.end()}};
+    }
+
+    /// @return std::nullopt if the operation overflows for a live argument vector
+    std::optional<std::vector<std::optional<int64_t>>> apply(char operation, const expression& left, const expression& right) {
+        std::vector<std::optional<int64_t>> values(alive.size());
+        for (std::size_t i = 0; i < alive.size(); ++i) {
+            if (!alive[i] || !left.values[i] || !right.values[i]) continue;
+            const int64_t lhs = *left.values[i];
+            const int64_t rhs = *right.values[i];
+            int64_t result;
+            switch (operation) {
+                case '+':
+                    if (__builtin_add_overflow(lhs, rhs, &result)) return std::nullopt;
+                    break;
+                case '-':
+                    if (__builtin_sub_overflow(lhs, rhs, &result)) return std::nullopt;
+                    break;
+                case '*':
+                    if (__builtin_mul_overflow(lhs, rhs, &result)) return std::nullopt;
+                    break;
+                default:
+                    if (rhs == 0) {
+                        if (!options.allow_division_by_zero) return std::nullopt;
+                        continue;
+                    }
+                    if (lhs == std::numeric_limits<int64_t>::min() && rhs == -1) return std::nullopt;
+                    result = lhs / rhs;
+                    break;
+            }
+            values[i] = result;
+        }
+        return values;
+    }
+
+    char pick_operator() {
+        if (chance(options.division_density)) return '/';
+        const unsigned total = options.plus_weight + options.minus_weight + options.multiply_weight;
+        if (total == 0) return '+';
+        const unsigned pick = uniform<unsigned>(0, total - 1);
+        if (pick < options.plus_weight) return '+';
+        if (pick < options.plus_weight + options.minus_weight) return '-';
+        return '*';
+    }
+
+    expression generate_negation(unsigned depth) {
+        auto operand = generate_expression(depth - 1);
+        std::vector<std::optional<int64_t>> values(alive.size());
+        for (std::size_t i = 0; i < alive.size(); ++i) {
+            if (!alive[i] || !operand.values[i]) continue;
+            // -INT64_MIN overflows
+            if (*operand.values[i] == std::numeric_limits<int64_t>::min()) return operand;
+            values[i] = -*operand.values[i];
+        }
+        return {"-" + parenthesize(operand, operand.kind != expression_kind::PRIMARY), expression_kind::NEGATION, std::move(values)};
+    }
+
+    expression generate_binary(unsigned depth) {
+        auto left = generate_expression(depth - 1);
+        auto right = generate_expression(depth - 1);
+        // An operator that overflows is replaced, keeping the operands. If nothing fits, the left operand remains.
+        for (char operation : {pick_operator(), '+', '-'}) {
+            auto values = apply(operation, left, right);
+            if (!values) continue;
+            // The parser is right associative, the right operand may be a chain of the same precedence
+            if (operation == '*' || operation == '/') {
+                auto text = parenthesize(left, left.kind == expression_kind::MULTIPLICATIVE || left.kind == expression_kind::ADDITIVE) +
+                    ' ' + operation + ' ' + parenthesize(right, right.kind == expression_kind::ADDITIVE);
+                return {std::move(text), expression_kind::MULTIPLICATIVE, std::move(*values)};
+            }
+            auto text = parenthesize(left, left.kind == expression_kind::ADDITIVE) + ' ' + operation + ' ' + right.text;
+            return {std::move(text), expression_kind::ADDITIVE, std::move(*values)};
+        }
+        return left;
+    }
+
+    expression generate_expression(unsigned depth) {
+        if (depth == 0 || chance(0.25)) return generate_operand();
+        if (chance(options.negation_density)) return generate_negation(depth);
+        auto result = generate_binary(depth);
+        // Parenthesized subexpressions keep long programs from degenerating into flat chains
+        if (result.kind != expression_kind::PRIMARY && chance(0.1)) {
+            result.text = "(" + result.text + ")";
+            result.kind = expression_kind::PRIMARY;
+        }
+        return result;
+    }
+
+    public:
+    generation(const generator_options& options, std::mt19937_64& random) : options(options), random(random), alive(options.argument_sets, true) {}
+
+    generated_program run() {
+        generated_program program;
+        program.arguments.assign(options.argument_sets, std::vector<int64_t>(options.parameters));
+        for (auto& arguments : program.arguments) {
+            for (auto& argument : arguments) argument = uniform<int64_t>(-options.max_argument, options.max_argument);
+        }
+
+        for (unsigned i = 0; i < options.parameters; ++i) {
+            symbols.push_back({symbol_name('p', i), true, {}});
+            for (const auto& arguments : program.arguments) symbols.back().values.push_back(arguments[i]);
+        }
+        for (unsigned i = 0; i < options.variables; ++i) {
+            symbols.push_back({symbol_name('v', i), false, std::vector<int64_t>(options.argument_sets)});
+        }
+        assignable = symbols.size();
+        for (unsigned i = 0; i < options.constants; ++i) {
+            symbols.push_back({symbol_name('c', i), true, std::vector<int64_t>(options.argument_sets, uniform<int64_t>(0, options.max_literal))});
+        }
+
+        auto& source = program.source;
+        auto declare = [&](const char* keyword, std::size_t begin, std::size_t end, bool initialize) {
+            if (begin == end) return;
+            source += keyword;
+            for (auto i = begin; i < end; ++i) {
+                source += (i == begin ? " " : ", ") + symbols[i].name;
+                if (initialize) source += " = " + std::to_string(symbols[i].values[0]);
+            }
+            source += ";\n";
+        };
+        declare("PARAM", 0, options.parameters, false);
+        declare("VAR", options.parameters, assignable, false);
+        declare("CONST", assignable, symbols.size(), true);
+
+        source += "BEGIN\n";
+        for (unsigned i = 0; i < options.statements && assignable > 0; ++i) {
+            auto value = generate_expression(options.max_expression_depth);
+            auto& target = symbols[uniform<std::size_t>(0, assignable - 1)];
+            source += "    " + target.name + " := " + value.text + ";\n";
+            for (std::size_t j = 0; j < alive.size(); ++j) {
+                if (!alive[j]) continue;
+                if (value.values[j]) {
+                    target.values[j] = *value.values[j];
+                } else {
+                    alive[j] = false;
+                }
+            }
+            target.readable = true;
+        }
+        auto result = generate_expression(options.max_expression_depth);
+        source += "    RETURN " + result.text + "\nEND.\n";
+
+        program.results.resize(alive.size());
+        for (std::size_t i = 0; i < alive.size(); ++i) {
+            if (alive[i]) program.results[i] = result.values[i];
+        }
+        return program;
+    }
+};
+
+} // namespace
+
+program_generator::program_generator(generator_options options, uint64_t seed) : options(options), random(seed) {}
+
+generated_program program_generator::generate() {
+    return generation(options, random).run();
+}
+
+} // namespace pljit::workload
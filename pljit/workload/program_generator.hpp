@@ -0,0 +1,65 @@
+#ifndef PLJIT_PROGRAM_GENERATOR_HPP
+#define PLJIT_PROGRAM_GENERATOR_HPP
+
+#include <cstdint>
+#include <optional>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace pljit::workload {
+
+/// Shape of the generated programs
+struct generator_options {
+    unsigned parameters = 4;
+    unsigned variables = 8;
+    unsigned constants = 4;
+    /// Assignments before the final RETURN statement
+    unsigned statements = 32;
+    /// Maximal nesting of operators in one expression, 0 generates single operands
+    unsigned max_expression_depth = 4;
+    /// Relative frequency of +, - and * among the binary operators that are not divisions
+    unsigned plus_weight = 4;
+    unsigned minus_weight = 4;
+    unsigned multiply_weight = 2;
+    /// Probability of a binary operator being a division
+    double division_density = 0.1;
+    /// Probability of an operator being a unary minus
+    double negation_density = 0.1;
+    /// Literals and constant values are drawn from [0, max_literal]
+    int64_t max_literal = 100;
+    /// Arguments are drawn from [-max_argument, max_argument]
+    int64_t max_argument = 1000;
+    /// Number of argument vectors generated for every program
+    unsigned argument_sets = 8;
+    /// Whether divisions may fail at runtime for some of the argument vectors
+    bool allow_division_by_zero = false;
+};
+
+struct generated_program {
+    std::string source;
+    /// One value per parameter in each vector
+    std::vector<std::vector<int64_t>> arguments;
+    /// Result of the program for each argument vector, std::nullopt if it divides by zero
+    std::vector<std::optional<int64_t>> results;
+};
+
+/**
+ * Generates random programs that pass semantic analysis: variables are assigned before they are read and
+ * constants are never assigned. The generator evaluates every expression for the argument vectors while it
+ * builds the program and replaces expressions that would overflow, so the results are well defined.
+ */
+class program_generator {
+    generator_options options;
+    std::mt19937_64 random;
+
+    public:
+    explicit program_generator(generator_options options = {}, uint64_t seed = 42);
+
+    /// Draws the next program
+    generated_program generate();
+};
+
+} // namespace pljit::workload
+
+#endif //PLJIT_PROGRAM_GENERATOR_HPP
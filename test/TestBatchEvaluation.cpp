@@ -0,0 +1,78 @@
+#include <gtest/gtest.h>
+
+#include "pljit/Pljit.hpp"
+
+using namespace pljit;
+
+TEST(BatchEvaluation, MatchesSingleCalls) {
+    const char* sources[] = {"PARAM a, b;\n"
+                             "VAR c, d;\n"
+                             "CONST k = 3;\n"
+                             "BEGIN\n"
+                             "c := a * k - b;\n"
+                             "d := -c + (a - 7) * (b + a);\n"
+                             "a := 10;\n"
+                             "RETURN (d - c) / (b - 5) + a\n"
+                             "END.",
+                             // Variables read before their first assignment
+                             "PARAM a, b;\n"
+                             "VAR c, d;\n"
+                             "BEGIN\n"
+                             "c := c + a;\n"
+                             "d := d * b + c;\n"
+                             "RETURN d - c\n"
+                             "END."};
+    for (const char* source : sources) {
+        Function function(source, execution_engine::INTERPRETER);
+
+        // Spans several tiles, with a partial last tile
+        const std::size_t n = 2500;
+        std::vector<int64_t> a(n), b(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            a[i] = static_cast<int64_t>(i) - 1000;
+            b[i] = static_cast<int64_t>(i % 11);
+        }
+        const int64_t* columns[] = {a.data(), b.data()};
+        std::vector<int64_t> out(n);
+        std::vector<uint8_t> errors(n, 42);
+        ASSERT_TRUE(function.evaluate_batch(columns, n, out.data(), errors.data()));
+
+        for (std::size_t i = 0; i < n; ++i) {
+            auto expected = function(a[i], b[i]);
+            EXPECT_EQ(errors[i] != 0, !expected) << "row " << i;
+            if (expected) {
+                EXPECT_EQ(out[i], *expected.get_result()) << "row " << i;
+            }
+        }
+    }
+}
+
+TEST(BatchEvaluation, ConstantResult) {
+    Function function("PARAM a; BEGIN RETURN 6 * 7 END.");
+    std::vector<int64_t> a(3, 1);
+    const int64_t* columns[] = {a.data()};
+    std::vector<int64_t> out(3);
+    std::vector<uint8_t> errors(3);
+    ASSERT_TRUE(function.evaluate_batch(columns, 3, out.data(), errors.data()));
+    EXPECT_EQ(out, std::vector<int64_t>(3, 42));
+    EXPECT_EQ(errors, std::vector<uint8_t>(3, 0));
+}
+
+TEST(BatchEvaluation, ErrorsDoNotAbortTheBatch) {
+    Function function("PARAM a; VAR b; BEGIN b := 100 / a; RETURN b + 1 END.");
+    std::vector<int64_t> a{1, 0, 50, 0};
+    const int64_t* columns[] = {a.data()};
+    std::vector<int64_t> out(4);
+    std::vector<uint8_t> errors(4);
+    ASSERT_TRUE(function.evaluate_batch(columns, 4, out.data(), errors.data()));
+    EXPECT_EQ(errors, (std::vector<uint8_t>{0, 1, 0, 1}));
+    EXPECT_EQ(out[0], 101);
+    EXPECT_EQ(out[2], 3);
+}
+
+TEST(BatchEvaluation, CompilationFailure) {
+    Function function("PARAM a; BEGIN RETURN b END.");
+    int64_t out;
+    uint8_t error;
+    EXPECT_FALSE(function.evaluate_batch(nullptr, 0, &out, &error));
+}
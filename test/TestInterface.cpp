@@ -1,7 +1,12 @@
 #include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <limits>
+#include <sstream>
 #include <thread>
 
 #include "pljit/Pljit.hpp"
+#include "pljit/source_management/diagnostics.hpp"
 
 using namespace pljit;
 
@@ -17,6 +22,39 @@ TEST(InterfaceTest, SingleThread) {
     EXPECT_EQ(*result.get_result(), 8);
 }
 
+TEST(InterfaceTest, SingleThreadInterpreter) {
+    pljit::Pljit compiler;
+
+    auto handle = compiler.register_function("PARAM a, b;BEGIN RETURN a / b END.", execution_engine::INTERPRETER);
+    auto result = handle(9, 2);
+    ASSERT_TRUE(result);
+    EXPECT_EQ(*result.get_result(), 4);
+    result = handle(1, 0);
+    EXPECT_FALSE(result);
+}
+
+TEST(InterfaceTest, SingleThreadBytecode) {
+    pljit::Pljit compiler;
+
+    auto handle = compiler.register_function("PARAM a, b;VAR c;BEGIN c := a * b; RETURN c / (b - 1) END.", execution_engine::BYTECODE);
+    auto result = handle(9, 2);
+    ASSERT_TRUE(result);
+    EXPECT_EQ(*result.get_result(), 18);
+    result = handle(1, 1);
+    EXPECT_FALSE(result);
+}
+
+TEST(InterfaceTest, SingleThreadClosure) {
+    pljit::Pljit compiler;
+
+    auto handle = compiler.register_function("PARAM a, b;VAR c;BEGIN c := a * b; RETURN c / (b - 1) END.", execution_engine::CLOSURE);
+    auto result = handle(9, 2);
+    ASSERT_TRUE(result);
+    EXPECT_EQ(*result.get_result(), 18);
+    result = handle(1, 1);
+    EXPECT_FALSE(result);
+}
+
 TEST(InterfaceTest, SingleThreadInvalidProgram) {
     pljit::Pljit compiler;
 
@@ -53,4 +91,503 @@ TEST(InterfaceTest, MultithreadedCompilation) {
             thread.join();
         }
     });
-}
\ No newline at end of file
+}
+TEST(InterfaceTest, MultithreadedFirstCall) {
+    // Every thread races for the first call of a freshly registered function
+    for (auto [source, valid] : {std::pair{"PARAM a; VAR b; BEGIN b := a * 3; RETURN b - 1 END.", true}, std::pair{"PARAM a; BEGIN RETURN c END.", false}}) {
+        pljit::Pljit compiler;
+        auto handle = compiler.register_function(source);
+        // Structured bindings cannot be captured in C++17
+        const bool expect_success = valid;
+        std::atomic<bool> start{false};
+        std::vector<std::thread> thread_pool;
+        for (unsigned i = 0; i < 64; ++i) {
+            thread_pool.emplace_back([&, handle, i]() mutable {
+                while (!start.load()) std::this_thread::yield();
+                auto res = handle(i);
+                EXPECT_EQ(static_cast<bool>(res), expect_success);
+                if (res) {
+                    EXPECT_EQ(*res.get_result(), static_cast<int64_t>(i) * 3 - 1);
+                }
+            });
+        }
+        start = true;
+        for (auto& thread : thread_pool) {
+            thread.join();
+        }
+    }
+}
+
+TEST(InterfaceTest, TieredExecution) {
+    pljit::Function function("PARAM a; VAR b; CONST c = 4; BEGIN b := +c * 2; RETURN (a * b) / (a - 1) END.", {execution_engine::CLOSURE, 16});
+
+    for (int64_t i = 2; i < 20; ++i) {
+        auto result = function(i);
+        ASSERT_TRUE(result);
+        EXPECT_EQ(*result.get_result(), i * 8 / (i - 1));
+    }
+    // Functions of a Pljit tier up on its compilation workers, standalone ones on the calling thread
+    for (unsigned i = 0; i < 1000 && !function.is_optimized(); ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    ASSERT_TRUE(function.is_optimized());
+
+    auto result = function(3);
+    ASSERT_TRUE(result);
+    EXPECT_EQ(*result.get_result(), 12);
+    EXPECT_FALSE(function(1));
+}
+
+TEST(InterfaceTest, TieredExecutionStaysInterpretedBelowThreshold) {
+    pljit::Pljit compiler({execution_engine::NATIVE, 1000});
+    auto handle = compiler.register_function("PARAM a; BEGIN RETURN a + 1 END.");
+    for (int64_t i = 0; i < 10; ++i) {
+        EXPECT_EQ(*handle(i).get_result(), i + 1);
+    }
+    EXPECT_FALSE(compiler.get(0).is_optimized());
+}
+
+TEST(InterfaceTest, MultithreadedTierUp) {
+    pljit::Pljit compiler({execution_engine::BYTECODE, 64});
+    auto handle = compiler.register_function("PARAM a, b; VAR c; BEGIN c := a - b; RETURN c * c END.");
+    ASSERT_NO_FATAL_FAILURE({
+        std::vector<std::thread> thread_pool;
+        for (unsigned i = 0; i < 16; ++i) {
+            thread_pool.emplace_back([handle, i]() mutable {
+                for (int64_t j = 0; j < 200; ++j) {
+                    auto res = handle(j, i);
+                    ASSERT_TRUE(res);
+                    EXPECT_EQ(*res.get_result(), (j - i) * (j - i));
+                }
+            });
+        }
+
+        for (auto& thread : thread_pool) {
+            thread.join();
+        }
+    });
+}
+
+TEST(InterfaceTest, CallWithCallerFrame) {
+    const char* source = "PARAM a, b; VAR c; CONST d = 3; BEGIN c := a * d; RETURN c / b END.";
+    for (auto engine : {execution_engine::INTERPRETER, execution_engine::NATIVE, execution_engine::BYTECODE, execution_engine::CLOSURE, execution_engine::COPY_AND_PATCH}) {
+        pljit::Function function(source, engine);
+        std::vector<int64_t> frame(function.get_frame_size());
+        for (int64_t i = 1; i < 10; ++i) {
+            const int64_t parameters[] = {i, i % 3};
+            auto result = function.call(parameters, frame.data());
+            if (i % 3 == 0) {
+                EXPECT_FALSE(result);
+            } else {
+                ASSERT_TRUE(result);
+                EXPECT_EQ(*result, i * 3 / (i % 3));
+            }
+        }
+    }
+}
+
+TEST(InterfaceTest, CallLargeFrame) {
+    // More variables than fit into the inline frame, identifiers consist of letters only
+    auto name = [](unsigned i) { return std::string{'v', static_cast<char>('a' + i / 26), static_cast<char>('a' + i % 26)}; };
+    std::string source = "PARAM a; VAR " + name(0);
+    std::string body = "BEGIN " + name(0) + " := a";
+    for (unsigned i = 1; i < 100; ++i) {
+        source += ", " + name(i);
+        body += "; " + name(i) + " := " + name(i - 1) + " + 1";
+    }
+    source += "; " + body + "; RETURN " + name(99) + " END.";
+    for (auto engine : {execution_engine::INTERPRETER, execution_engine::BYTECODE, execution_engine::CLOSURE}) {
+        pljit::Function function(source, engine);
+        ASSERT_GT(function.get_frame_size(), execution::compiled_function::inline_frame_size);
+        const int64_t parameters[] = {5};
+        auto result = function.call(parameters);
+        ASSERT_TRUE(result);
+        EXPECT_EQ(*result, 104);
+    }
+}
+
+TEST(InterfaceTest, DeadStoresShrinkTheFrame) {
+    const char* source = "PARAM a, b; VAR x, y, z; CONST k = 3; BEGIN x := a * k; y := x - b; z := b / 2; RETURN x + 1 END.";
+    for (auto engine : {execution_engine::INTERPRETER, execution_engine::NATIVE, execution_engine::BYTECODE, execution_engine::CLOSURE, execution_engine::COPY_AND_PATCH}) {
+        pljit::Function function(source, engine);
+        pljit::Function unoptimized(source, {engine, 0, optimization::optimization_level::O0});
+        // Only the parameters and x remain in the frame
+        EXPECT_LT(function.get_frame_size(), unoptimized.get_frame_size());
+        auto result = function(4, 1);
+        ASSERT_TRUE(result);
+        EXPECT_EQ(*result.get_result(), 13);
+    }
+}
+
+TEST(InterfaceTest, OverflowWrapsInEveryEngine) {
+    constexpr auto min = std::numeric_limits<int64_t>::min();
+    constexpr auto max = std::numeric_limits<int64_t>::max();
+    struct test_case {
+        const char* source;
+        std::vector<int64_t> parameters;
+        int64_t expected;
+    };
+    const test_case cases[] = {
+        {"PARAM a, b; BEGIN RETURN a * b + a END.", {max, 3}, static_cast<int64_t>(static_cast<uint64_t>(max) * 4)},
+        {"PARAM a, b; BEGIN RETURN a - b END.", {min, 1}, max},
+        {"PARAM a, b; BEGIN RETURN a / b END.", {min, -1}, min},
+        {"PARAM a; BEGIN RETURN -a END.", {min}, min},
+        // Folded at compile time by the optimizer
+        {"CONST m = 9223372036854775807; BEGIN RETURN (m + 1) / -1 END.", {}, min},
+        {"CONST m = 9223372036854775807; BEGIN RETURN m * m END.", {}, 1},
+    };
+    for (const auto& test : cases) {
+        // The unoptimized interpreter is the reference
+        pljit::Function reference(test.source, {execution_engine::INTERPRETER, 0, optimization::optimization_level::O0});
+        auto expected = reference.call(test.parameters.data());
+        ASSERT_TRUE(expected) << test.source;
+        EXPECT_EQ(*expected, test.expected) << test.source;
+        for (auto engine : {execution_engine::INTERPRETER, execution_engine::NATIVE, execution_engine::BYTECODE, execution_engine::CLOSURE, execution_engine::COPY_AND_PATCH}) {
+            for (auto level : {optimization::optimization_level::O0, optimization::optimization_level::O1, optimization::optimization_level::O2}) {
+                pljit::Function function(test.source, {engine, 0, level});
+                auto result = function.call(test.parameters.data());
+                ASSERT_TRUE(result) << test.source;
+                EXPECT_EQ(*result, *expected) << test.source;
+            }
+        }
+    }
+}
+
+TEST(InterfaceTest, DivisionByZeroIsReportedByEveryEngine) {
+    for (auto engine : {execution_engine::INTERPRETER, execution_engine::NATIVE, execution_engine::BYTECODE, execution_engine::CLOSURE, execution_engine::COPY_AND_PATCH}) {
+        for (auto level : {optimization::optimization_level::O0, optimization::optimization_level::O1, optimization::optimization_level::O2}) {
+            pljit::Function function("PARAM a; VAR b; BEGIN b := 1000 / (a - 10); RETURN b + 1 END.", {engine, 0, level});
+            ASSERT_TRUE(function.wait());
+            std::ostringstream messages;
+            source_management::diagnostics_redirect redirect(messages);
+            EXPECT_FALSE(function(10));
+            EXPECT_EQ(messages.str(), "Error: Division by zero\n");
+            EXPECT_EQ(*function(11).get_result(), 1001);
+        }
+    }
+}
+
+TEST(InterfaceTest, CallWithWrongNumberOfArguments) {
+    for (auto engine : {execution_engine::INTERPRETER, execution_engine::NATIVE, execution_engine::BYTECODE, execution_engine::CLOSURE, execution_engine::COPY_AND_PATCH}) {
+        pljit::Function function("PARAM a, b, c; BEGIN RETURN a + b + c END.", engine);
+        EXPECT_FALSE(function(1, 2));
+        EXPECT_FALSE(function(1, 2, 3, 4));
+        EXPECT_EQ(*function(1, 2, 3).get_result(), 6);
+    }
+
+    function_options options;
+    options.background_compilation = true;
+    pljit::Function pending("PARAM a, b; BEGIN RETURN a * b END.", options);
+    // Checked against the privately analyzed AST while compilation is pending
+    EXPECT_FALSE(pending.call_with(pending_compilation::SLOW_PATH, 3));
+    EXPECT_EQ(*pending.call_with(pending_compilation::SLOW_PATH, 3, 4).get_result(), 12);
+}
+
+TEST(InterfaceTest, CallInvalidProgram) {
+    pljit::Function function("PARAM a; BEGIN RETURN b END.");
+    const int64_t parameters[] = {1};
+    EXPECT_FALSE(function.call(parameters));
+    EXPECT_EQ(function.get_frame_size(), 0u);
+}
+
+TEST(InterfaceTest, OptimizationLevels) {
+    pljit::Pljit compiler(optimization::optimization_level::O0);
+    auto unoptimized = compiler.register_function("PARAM a; CONST b = 2; BEGIN RETURN a * (b + 1) END.");
+    auto optimized = compiler.register_function("PARAM a; CONST b = 2; BEGIN RETURN a * (b + 1) END.", {execution_engine::NATIVE, 0, optimization::optimization_level::O2});
+    EXPECT_EQ(*unoptimized(5).get_result(), 15);
+    EXPECT_EQ(*optimized(5).get_result(), 15);
+
+    EXPECT_TRUE(compiler.get(0).get_pass_statistics().empty());
+    const auto& statistics = compiler.get(1).get_pass_statistics();
+    ASSERT_FALSE(statistics.empty());
+    EXPECT_EQ(statistics[1].name, "ssa_optimization");
+    EXPECT_EQ(statistics[1].nodes_folded, 2u);
+}
+
+TEST(InterfaceTest, ConcurrentRegistration) {
+    pljit::Pljit compiler;
+    auto first = compiler.register_function("PARAM a; BEGIN RETURN a + 1 END.");
+    std::vector<std::thread> thread_pool;
+    // Registering threads fill several segments of the registry while others call and look up functions
+    for (unsigned i = 0; i < 8; ++i) {
+        thread_pool.emplace_back([&compiler, i] {
+            for (int64_t j = 0; j < 100; ++j) {
+                auto handle = compiler.register_function("PARAM a; BEGIN RETURN a * " + std::to_string(j) + " END.");
+                EXPECT_EQ(&compiler.get(handle.get_id()), &compiler.get(handle.get_id()));
+                EXPECT_EQ(*handle(static_cast<int64_t>(i)).get_result(), static_cast<int64_t>(i) * j);
+            }
+        });
+        thread_pool.emplace_back([first, &compiler]() mutable {
+            for (int64_t j = 0; j < 100; ++j) {
+                EXPECT_EQ(*first(j).get_result(), j + 1);
+                EXPECT_EQ(*compiler.get(0)(j).get_result(), j + 1);
+            }
+        });
+    }
+    for (auto& thread : thread_pool) {
+        thread.join();
+    }
+}
+
+TEST(InterfaceTest, StatisticsDuringConcurrentRegistration) {
+    pljit::function_options options;
+    options.collect_compile_statistics = true;
+    options.collect_runtime_statistics = true;
+    pljit::Pljit compiler(options);
+    std::atomic<unsigned> registering{4};
+    std::vector<std::thread> thread_pool;
+    for (unsigned i = 0; i < 4; ++i) {
+        thread_pool.emplace_back([&compiler, &registering, i] {
+            for (int64_t j = 0; j < 200; ++j) {
+                compiler.register_function("PARAM a; BEGIN RETURN a * " + std::to_string(j) + " - " + std::to_string(i) + " END.");
+            }
+            --registering;
+        });
+    }
+    // Ids handed out but not yet published are skipped
+    thread_pool.emplace_back([&compiler, &registering] {
+        while (registering > 0) {
+            EXPECT_LE(compiler.stats_snapshot().functions.size(), 800u);
+            compiler.get_compile_statistics();
+        }
+    });
+    for (auto& thread : thread_pool) {
+        thread.join();
+    }
+    EXPECT_EQ(compiler.stats_snapshot().functions.size(), 800u);
+}
+
+TEST(InterfaceTest, BackgroundCompilation) {
+    function_options options;
+    options.background_compilation = true;
+    pljit::Pljit compiler(options);
+    std::vector<function_handle> handles;
+    for (int64_t i = 0; i < 32; ++i) {
+        handles.push_back(compiler.register_function("PARAM a; BEGIN RETURN a * " + std::to_string(i) + " END."));
+    }
+    auto invalid = compiler.register_function("PARAM a; BEGIN RETURN b END.");
+
+    for (int64_t i = 0; i < 32; ++i) {
+        auto result = handles[i].call_with(pending_compilation::SLOW_PATH, 3);
+        ASSERT_TRUE(result);
+        EXPECT_EQ(*result.get_result(), 3 * i);
+        EXPECT_TRUE(handles[i].wait());
+        EXPECT_TRUE(handles[i].ready());
+        EXPECT_EQ(*handles[i].call_with(pending_compilation::FAIL, 2).get_result(), 2 * i);
+    }
+    EXPECT_FALSE(invalid.wait());
+    EXPECT_TRUE(invalid.ready());
+    EXPECT_FALSE(invalid(1));
+}
+
+TEST(InterfaceTest, PendingCompilationPolicies) {
+    // Not registered with a Pljit, so the background compilation never starts and the function stays pending
+    function_options options;
+    options.background_compilation = true;
+    pljit::Function function("PARAM a; BEGIN RETURN a + 1 END.", options);
+
+    EXPECT_FALSE(function.ready());
+    EXPECT_FALSE(function.call_with(pending_compilation::FAIL, 1));
+    auto result = function.call_with(pending_compilation::SLOW_PATH, 1);
+    ASSERT_TRUE(result);
+    EXPECT_EQ(*result.get_result(), 2);
+    EXPECT_FALSE(function.ready());
+
+    // Compiles on the calling thread
+    result = function.call_with(pending_compilation::WAIT, 2);
+    ASSERT_TRUE(result);
+    EXPECT_EQ(*result.get_result(), 3);
+    EXPECT_TRUE(function.ready());
+    EXPECT_EQ(*function.call_with(pending_compilation::FAIL, 3).get_result(), 4);
+}
+
+TEST(InterfaceTest, IdenticalSourcesShareFunction) {
+    EXPECT_EQ(compilation_cache::normalize("  PARAM a;\n\tBEGIN  RETURN a END. \n"), "PARAM a; BEGIN RETURN a END.");
+
+    pljit::Pljit compiler;
+    auto first = compiler.register_function("PARAM a; BEGIN RETURN a * 2 END.");
+    auto same = compiler.register_function("PARAM a;\n BEGIN\n\tRETURN a * 2\nEND.\n");
+    auto other_engine = compiler.register_function("PARAM a; BEGIN RETURN a * 2 END.", execution_engine::BYTECODE);
+    auto other_source = compiler.register_function("PARAM b; BEGIN RETURN b * 2 END.");
+
+    EXPECT_EQ(first.get_id(), same.get_id());
+    EXPECT_NE(first.get_id(), other_engine.get_id());
+    EXPECT_NE(first.get_id(), other_source.get_id());
+    EXPECT_EQ(*same(4).get_result(), 8);
+    // Compiled once, through the first handle's call
+    EXPECT_TRUE(first.ready());
+    EXPECT_FALSE(other_engine.ready());
+}
+
+TEST(InterfaceTest, ConcurrentRegistrationOfIdenticalSources) {
+    pljit::Pljit compiler;
+    std::vector<std::thread> thread_pool;
+    std::vector<unsigned> ids(16);
+    for (unsigned i = 0; i < 16; ++i) {
+        thread_pool.emplace_back([&compiler, &ids, i] {
+            for (unsigned j = 0; j < 100; ++j) {
+                auto handle = compiler.register_function("PARAM a; BEGIN RETURN a - 1 END.");
+                EXPECT_EQ(*handle(static_cast<int64_t>(j)).get_result(), static_cast<int64_t>(j) - 1);
+                ids[i] = handle.get_id();
+            }
+        });
+    }
+    for (auto& thread : thread_pool) {
+        thread.join();
+    }
+    for (auto id : ids) {
+        EXPECT_EQ(id, ids[0]);
+    }
+}
+
+TEST(InterfaceTest, BulkRegistration) {
+    pljit::Pljit compiler;
+    std::vector<std::string> sources;
+    for (unsigned i = 0; i < 1000; ++i) {
+        if (i % 100 == 7) {
+            sources.push_back("PARAM a; BEGIN RETURN b END.");
+        } else {
+            sources.push_back("PARAM a; BEGIN RETURN a + " + std::to_string(i % 500) + " END.");
+        }
+    }
+    auto results = compiler.register_functions(sources);
+    ASSERT_EQ(results.size(), sources.size());
+    for (unsigned i = 0; i < results.size(); ++i) {
+        auto& result = results[i];
+        EXPECT_TRUE(result.handle.ready());
+        if (i % 100 == 7) {
+            EXPECT_FALSE(result.success);
+            EXPECT_NE(result.diagnostics.find("Undeclared identifier \"b\""), std::string_view::npos);
+            EXPECT_FALSE(result.handle(1));
+        } else {
+            EXPECT_TRUE(result.success);
+            EXPECT_TRUE(result.diagnostics.empty());
+            EXPECT_EQ(*result.handle(1).get_result(), 1 + static_cast<int64_t>(i % 500));
+        }
+    }
+    // Identical sources in the batch share one function
+    EXPECT_EQ(results[1].handle.get_id(), results[501].handle.get_id());
+    EXPECT_EQ(results[7].handle.get_id(), results[107].handle.get_id());
+    EXPECT_NE(results[1].handle.get_id(), results[2].handle.get_id());
+}
+
+TEST(InterfaceTest, BulkRegistrationWithBackgroundCompilationPrintsNothing) {
+    function_options options;
+    options.background_compilation = true;
+    pljit::Pljit compiler(options);
+    std::vector<std::string> sources;
+    for (unsigned i = 0; i < 1000; ++i) {
+        sources.push_back("PARAM a; BEGIN RETURN b + " + std::to_string(i) + " END.");
+    }
+    testing::internal::CaptureStderr();
+    auto results = compiler.register_functions(sources);
+    const auto printed = testing::internal::GetCapturedStderr();
+    EXPECT_TRUE(printed.empty()) << printed;
+    for (const auto& result : results) {
+        EXPECT_FALSE(result.success);
+        EXPECT_FALSE(result.diagnostics.empty());
+    }
+}
+
+TEST(InterfaceTest, BulkRegistrationEmpty) {
+    pljit::Pljit compiler;
+    EXPECT_TRUE(compiler.register_functions({}).empty());
+}
+
+TEST(InterfaceTest, CompileStatistics) {
+    pljit::function_options options;
+    options.collect_compile_statistics = true;
+    pljit::Pljit compiler(options);
+    const std::string source = "PARAM a; VAR b; BEGIN b := a + 1; RETURN b END.\n";
+    auto handle = compiler.register_function(source);
+    ASSERT_TRUE(handle.wait());
+    const auto* statistics = compiler.get(handle.get_id()).get_compile_statistics();
+    ASSERT_TRUE(statistics);
+    EXPECT_EQ(statistics->compilations, 1u);
+    EXPECT_EQ(statistics->bytes_lexed, source.size());
+    // PARAM a ; VAR b ; BEGIN b := a + 1 ; RETURN b END .
+    EXPECT_EQ(statistics->tokens, 17u);
+    EXPECT_GT(statistics->parse_tree_nodes, 0u);
+    EXPECT_GT(statistics->ast_nodes, 0u);
+    EXPECT_EQ(statistics->symbols, 2u);
+    EXPECT_EQ(statistics->passes.size(), compiler.get(handle.get_id()).get_pass_statistics().size());
+    EXPECT_GT(statistics->phase_times[pljit::compile_statistics::PARSE].count(), 0);
+    EXPECT_GT(statistics->phase_times[pljit::compile_statistics::CODE_GENERATION].count(), 0);
+
+    // Failed compilations are measured as well
+    compiler.register_function("PARAM a; BEGIN RETURN c END.").wait();
+    // Not measured
+    auto unmeasured = compiler.register_function(source, pljit::execution_engine::BYTECODE);
+    ASSERT_TRUE(unmeasured.wait());
+    EXPECT_FALSE(compiler.get(unmeasured.get_id()).get_compile_statistics());
+
+    const auto total = compiler.get_compile_statistics();
+    EXPECT_EQ(total.compilations, 2u);
+    EXPECT_EQ(total.tokens, 17u + 8u);
+    // The failed function has no symbol table
+    EXPECT_EQ(total.symbols, 2u);
+    EXPECT_EQ(total.passes.size(), statistics->passes.size());
+    EXPECT_EQ(total.passes[0].runs, statistics->passes[0].runs);
+}
+
+TEST(InterfaceTest, RuntimeStatistics) {
+    pljit::function_options options;
+    options.collect_runtime_statistics = true;
+    pljit::Pljit compiler(options);
+    auto unmeasured = compiler.register_function("PARAM a; BEGIN RETURN a END.", pljit::execution_engine::BYTECODE);
+    auto divide = compiler.register_function("PARAM a, b; BEGIN RETURN a / b END.");
+    EXPECT_EQ(*unmeasured(1).get_result(), 1);
+
+    std::vector<std::thread> thread_pool;
+    for (unsigned i = 0; i < 8; ++i) {
+        thread_pool.emplace_back([divide]() mutable {
+            for (int64_t j = 0; j < 1000; ++j) {
+                divide(j, j % 100);
+            }
+        });
+    }
+    for (auto& thread : thread_pool) {
+        thread.join();
+    }
+
+    const auto snapshot = compiler.stats_snapshot();
+    ASSERT_EQ(snapshot.functions.size(), 1u);
+    const auto& statistics = snapshot.functions[0];
+    EXPECT_EQ(statistics.function_id, divide.get_id());
+    EXPECT_EQ(statistics.calls, 8000u);
+    EXPECT_EQ(statistics.failures, 80u);
+    uint64_t bucketed = 0;
+    for (auto count : statistics.latency_buckets) bucketed += count;
+    EXPECT_EQ(bucketed, 8000u);
+    EXPECT_GT(statistics.total_latency.count(), 0);
+
+    const auto text = snapshot.to_openmetrics();
+    const auto id = std::to_string(divide.get_id());
+    EXPECT_NE(text.find("pljit_function_calls_total{function=\"" + id + "\"} 8000\n"), std::string::npos);
+    EXPECT_NE(text.find("pljit_function_failures_total{function=\"" + id + "\"} 80\n"), std::string::npos);
+    EXPECT_NE(text.find("pljit_function_call_latency_seconds_bucket{function=\"" + id + "\",le=\"+Inf\"} 8000\n"), std::string::npos);
+    EXPECT_NE(text.find("# TYPE pljit_function_call_latency_seconds histogram\n"), std::string::npos);
+    EXPECT_EQ(text.substr(text.size() - 6), "# EOF\n");
+}
+
+TEST(InterfaceTest, RuntimeStatisticsBucketBoundsAreInclusive) {
+    using std::chrono::nanoseconds;
+    runtime_statistics statistics;
+    for (int64_t latency : {0, 16, 17, 32, 33}) {
+        statistics.record(nanoseconds(latency), true);
+    }
+    const auto last_bound = function_statistics::bucket_bound(function_statistics::number_of_buckets - 1);
+    statistics.record(last_bound, true);
+    statistics.record(last_bound + nanoseconds(1), true);
+
+    const auto collected = statistics.collect(0);
+    EXPECT_EQ(collected.latency_buckets[0], 2u);
+    EXPECT_EQ(collected.latency_buckets[1], 2u);
+    EXPECT_EQ(collected.latency_buckets[2], 1u);
+    EXPECT_EQ(collected.latency_buckets[function_statistics::number_of_buckets - 1], 1u);
+    EXPECT_EQ(collected.latency_buckets[function_statistics::number_of_buckets], 1u);
+
+    // A call of exactly 16ns is counted by le="1.6e-08"
+    const auto text = statistics_snapshot{{collected}}.to_openmetrics();
+    EXPECT_NE(text.find("pljit_function_call_latency_seconds_bucket{function=\"0\",le=\"1.6e-08\"} 2\n"), std::string::npos) << text;
+}
@@ -1,9 +1,13 @@
 #include "pljit/semantic_analysis/ASTCreator.hpp"
 #include <pljit/execution/ExecutionContext.hpp>
 #include <pljit/lexer/lexer.hpp>
+#include <pljit/optimization/pass_manager.hpp>
 #include <pljit/optimization/passes/UnaryPlusRemoval.hpp>
+#include <pljit/optimization/passes/algebraic_simplification.hpp>
 #include <pljit/optimization/passes/constant_propagation.hpp>
 #include <pljit/optimization/passes/dead_code_elimination.hpp>
+#include <pljit/optimization/passes/dead_store_elimination.hpp>
+#include <pljit/optimization/passes/reassociation.hpp>
 #include <pljit/parser/parser.hpp>
 #include <pljit/semantic_analysis/AST.hpp>
 #include <pljit/semantic_analysis/dot_print_visitor.hpp>
@@ -130,3 +134,219 @@ TEST_F(Optimization, ConstantPropagationDivisionByZero) {
 
     ASSERT_EQ(to_dot(*ref_ast), to_dot(*optimized_ast));
 }
+
+TEST_F(Optimization, ConstantPropagationReassignment) {
+    auto ast = create_ast("PARAM a;\n"
+                          "VAR b;\n"
+                          "BEGIN\n"
+                          "b := 5;\n"
+                          "b := a;\n"
+                          "RETURN b\n"
+                          "END.");
+    pljit::optimization::passes::constant_propagation cp;
+    cp.optimize_ast(ast);
+
+    pljit::execution::ExecutionContext context(ast->getSymbolTable(), 42);
+    EXPECT_EQ(ast->evaluate(context), 42);
+}
+
+TEST_F(Optimization, DeadStoreElimination) {
+    auto ref_ast = create_ast("PARAM a, b; VAR x, z, w;\n"
+                              "BEGIN\n"
+                              "w := b;\n"
+                              "x := b - a;\n"
+                              "z := x * x;\n"
+                              "RETURN z + w\n"
+                              "END.");
+    auto ast = create_ast("PARAM a, b; VAR x, y, z, w; CONST k = 3, unused = 4;\n"
+                          "BEGIN\n"
+                          "x := a * k;\n"
+                          "y := x + 1;\n"
+                          "w := b;\n"
+                          "x := b - a;\n"
+                          "z := x * x;\n"
+                          "a := 7;\n"
+                          "RETURN z + w;\n"
+                          "y := z\n"
+                          "END.");
+    // Runs after dead code elimination, which removes the statement after the return
+    pljit::optimization::passes::dead_code_elimination().optimize_ast(ast);
+    pljit::optimization::passes::dead_store_elimination().optimize_ast(ast);
+    EXPECT_EQ(to_dot(*ast), to_dot(*ref_ast));
+
+    // y, k and unused are gone, the remaining symbols keep their order
+    const auto& symbols = ast->getSymbolTable();
+    ASSERT_EQ(symbols.size(), 5u);
+    EXPECT_EQ(symbols.get_number_of_parameters(), 2u);
+    EXPECT_EQ(symbols.get_number_of_variables(), 3u);
+    EXPECT_EQ(symbols.get_number_of_constants(), 0u);
+    EXPECT_EQ(symbols.get(2).get_name(), "x");
+    EXPECT_EQ(symbols.get(3).get_name(), "z");
+    EXPECT_EQ(symbols.get(4).get_name(), "w");
+    for (symbol_table::symbol_handle handle = 0; handle < symbols.size(); ++handle) {
+        EXPECT_EQ(symbols.get(handle).id, handle);
+    }
+
+    pljit::execution::ExecutionContext context(symbols, 2, 5);
+    EXPECT_EQ(ast->evaluate(context), 9 + 5);
+}
+
+TEST_F(Optimization, DeadStoreEliminationKeepsDivisionByZero) {
+    auto ast = create_ast("PARAM a; VAR x, y; CONST k = 2; BEGIN x := k / a; y := a / 2; RETURN a END.");
+    pljit::optimization::passes::UnaryPlusRemoval().optimize_ast(ast);
+    pljit::optimization::passes::dead_store_elimination().optimize_ast(ast);
+    // x := k / a may fail and stays, y := a / 2 cannot
+    EXPECT_EQ(ast->get_number_of_statements(), 2u);
+    const auto& symbols = ast->getSymbolTable();
+    EXPECT_EQ(symbols.size(), 3u);
+    EXPECT_EQ(symbols.get(2).type, symbol::CONSTANT);
+
+    pljit::execution::ExecutionContext failing(symbols, 0);
+    EXPECT_FALSE(ast->evaluate(failing));
+    pljit::execution::ExecutionContext context(symbols, 1);
+    EXPECT_EQ(ast->evaluate(context), 1);
+}
+
+TEST_F(Optimization, AlgebraicSimplification) {
+    auto ref_ast = create_ast("PARAM a, b; VAR x, y, z;\n"
+                              "BEGIN\n"
+                              "x := a;\n"
+                              "y := -(b - a);\n"
+                              "z := a * 8 + b;\n"
+                              "RETURN x + y + z + a + b\n"
+                              "END.");
+    // Operators are right associative, 0 - b - a is 0 - (b - a)
+    auto ast = create_ast("PARAM a, b; VAR x, y, z;\n"
+                          "BEGIN\n"
+                          "x := a * 1 + 0;\n"
+                          "y := 0 - b - a;\n"
+                          "z := 8 * a - -b;\n"
+                          "RETURN x + y + z + (b - b) + -(-a) / 1 + 1 * b - 0\n"
+                          "END.");
+    pljit::optimization::passes::UnaryPlusRemoval().optimize_ast(ref_ast);
+    pljit::optimization::passes::algebraic_simplification().optimize_ast(ast);
+    EXPECT_EQ(to_dot(*ast), to_dot(*ref_ast));
+}
+
+TEST_F(Optimization, AlgebraicSimplificationKeepsDivisionByZero) {
+    auto ast = create_ast("PARAM a, b; BEGIN RETURN (a / b) * 0 + (a / b - a / b) + (a / 2) * 0 END.");
+    auto ref_ast = create_ast("PARAM a, b; BEGIN RETURN (a / b) * 0 + (a / b - a / b) END.");
+    pljit::optimization::passes::UnaryPlusRemoval().optimize_ast(ref_ast);
+    pljit::optimization::passes::algebraic_simplification().optimize_ast(ast);
+    EXPECT_EQ(to_dot(*ast), to_dot(*ref_ast));
+
+    pljit::execution::ExecutionContext context(ast->getSymbolTable(), 5, 0);
+    EXPECT_FALSE(ast->evaluate(context));
+}
+
+TEST_F(Optimization, Reassociation) {
+    auto ref_ast = create_ast("PARAM a, b, c, d, f; BEGIN RETURN ((((a + b) + (c + d)) + 5) * 6 + f * (f - 1)) + 3 END.");
+    auto ast = create_ast("PARAM a, b, c, d, f; BEGIN RETURN 2 * (a + 1 + b + c + d + 4) * 3 + f * (f - 1) + 3 END.");
+    pljit::optimization::passes::UnaryPlusRemoval().optimize_ast(ref_ast);
+    pljit::optimization::passes::UnaryPlusRemoval().optimize_ast(ast);
+
+    pljit::execution::ExecutionContext context(ast->getSymbolTable(), 1, 2, 3, 4, 5);
+    const auto expected = ast->evaluate(context);
+    pljit::optimization::passes::reassociation().optimize_ast(ast);
+    EXPECT_EQ(to_dot(*ast), to_dot(*ref_ast));
+    EXPECT_EQ(ast->evaluate(context), expected);
+
+    // A balanced chain stays as it is
+    const auto reference = to_dot(*ast);
+    pljit::optimization::passes::reassociation().optimize_ast(ast);
+    EXPECT_EQ(to_dot(*ast), reference);
+}
+
+TEST_F(Optimization, ReassociationWrapsAround) {
+    // The intermediate sums overflow in the balanced order, the result is the same
+    auto ast = create_ast("PARAM a, b; BEGIN RETURN a + 9223372036854775807 + b + 9223372036854775807 END.");
+    pljit::optimization::passes::UnaryPlusRemoval().optimize_ast(ast);
+    pljit::optimization::passes::reassociation().optimize_ast(ast);
+    pljit::execution::ExecutionContext context(ast->getSymbolTable(), 5, 7);
+    EXPECT_EQ(ast->evaluate(context), 10);
+}
+
+TEST_F(Optimization, PassManagerO0) {
+    auto ast = create_ast("PARAM a; CONST b = 2; BEGIN RETURN +a * b END.");
+    auto reference = to_dot(*ast);
+
+    pass_manager passes(optimization_level::O0);
+    EXPECT_EQ(passes.run(ast), 1u);
+    EXPECT_EQ(to_dot(*ast), reference);
+    EXPECT_TRUE(passes.get_statistics().empty());
+}
+
+TEST_F(Optimization, PassManagerO1) {
+    auto ref_ast = create_ast("PARAM a; BEGIN RETURN 24 END.");
+    auto ast = create_ast("PARAM a; VAR b; CONST c = 4; BEGIN b := +c * 2; RETURN b * 3; a := a + 1 END.");
+
+    pass_manager passes(optimization_level::O1);
+    EXPECT_EQ(passes.run(ast), 1u);
+    pljit::optimization::passes::UnaryPlusRemoval upr;
+    upr.optimize_ast(ref_ast);
+    EXPECT_EQ(to_dot(*ast), to_dot(*ref_ast));
+
+    const auto& statistics = passes.get_statistics();
+    ASSERT_EQ(statistics.size(), 6u);
+    EXPECT_EQ(statistics[0].name, "unary_plus_removal");
+    // The AST creator wraps operands into unary plus nodes, +c being one of them
+    EXPECT_EQ(statistics[0].nodes_folded, 6u);
+    EXPECT_EQ(statistics[1].name, "constant_propagation");
+    // c * 2 and b * 3 are folded into one literal each
+    EXPECT_EQ(statistics[1].nodes_folded, 4u);
+    EXPECT_EQ(statistics[2].name, "reassociation");
+    EXPECT_EQ(statistics[3].name, "algebraic_simplification");
+    EXPECT_EQ(statistics[3].nodes_folded, 0u);
+    EXPECT_EQ(statistics[4].name, "dead_code_elimination");
+    EXPECT_EQ(statistics[4].statements_removed, 1u);
+    EXPECT_EQ(statistics[5].name, "dead_store_elimination");
+    // b is never read after constant propagation
+    EXPECT_EQ(statistics[5].statements_removed, 1u);
+    EXPECT_EQ(ast->getSymbolTable().size(), 1u);
+    for (const auto& pass : statistics) {
+        EXPECT_EQ(pass.runs, 1u);
+    }
+
+    std::stringstream output;
+    passes.print_statistics(output);
+    EXPECT_NE(output.str().find("constant_propagation"), std::string::npos);
+}
+
+TEST_F(Optimization, PassManagerO2ReachesFixpoint) {
+    auto ast = create_ast("PARAM a; VAR b; CONST c = 4; BEGIN b := +c * 2; RETURN b * 3; a := a + 1 END.");
+    auto o1_ast = create_ast("PARAM a; VAR b; CONST c = 4; BEGIN b := +c * 2; RETURN b * 3; a := a + 1 END.");
+    pass_manager(optimization_level::O1).run(o1_ast);
+
+    pass_manager passes(optimization_level::O2);
+    // The second iteration does not change the AST anymore
+    EXPECT_EQ(passes.run(ast), 2u);
+    EXPECT_EQ(to_dot(*ast), to_dot(*o1_ast));
+    for (const auto& pass : passes.get_statistics()) {
+        EXPECT_EQ(pass.runs, 2u);
+    }
+}
+
+TEST_F(Optimization, PassManagerO2RemovesDeadCodeAndStores) {
+    auto ref_ast = create_ast("PARAM a, b; VAR t; BEGIN t := a / b; RETURN a * 3 + 1 END.");
+    pljit::optimization::passes::UnaryPlusRemoval().optimize_ast(ref_ast);
+    auto ast = create_ast("PARAM a, b; VAR x, y, z, w; CONST k = 3;\n"
+                          "BEGIN\n"
+                          "x := a * k;\n"
+                          "y := x - b;\n"
+                          "z := b / 2;\n"
+                          "w := a / b;\n"
+                          "RETURN x + 1;\n"
+                          "y := 7\n"
+                          "END.");
+    pass_manager(optimization_level::O2).run(ast);
+    // y and z are never read and cannot fail, w is never read but may divide by zero
+    EXPECT_EQ(to_dot(*ast), to_dot(*ref_ast));
+    const auto& symbols = ast->getSymbolTable();
+    EXPECT_EQ(symbols.get_number_of_variables(), 1u);
+    EXPECT_EQ(symbols.get_number_of_constants(), 0u);
+
+    pljit::execution::ExecutionContext failing(symbols, 1, 0);
+    EXPECT_FALSE(ast->evaluate(failing));
+    pljit::execution::ExecutionContext context(symbols, 4, 1);
+    EXPECT_EQ(ast->evaluate(context), 13);
+}
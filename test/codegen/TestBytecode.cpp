@@ -0,0 +1,92 @@
+#include "pljit/semantic_analysis/ASTCreator.hpp"
+#include <pljit/codegen/bytecode/bytecode_function.hpp>
+#include <pljit/codegen/bytecode/bytecode_generator.hpp>
+#include <pljit/execution/ExecutionContext.hpp>
+#include <pljit/lexer/lexer.hpp>
+#include <pljit/parser/parser.hpp>
+#include <pljit/semantic_analysis/AST.hpp>
+#include <pljit/source_management/SourceCode.hpp>
+#include <limits>
+#include <gtest/gtest.h>
+
+using namespace pljit;
+using namespace pljit::semantic_analysis;
+using namespace pljit::source_management;
+using namespace pljit::codegen::bytecode;
+
+class Bytecode : public ::testing::Test {
+    protected:
+    SourceCode code;
+    std::unique_ptr<FunctionNode> ast;
+
+    program generate(std::string_view source_string) {
+        code = SourceCode(source_string);
+        pljit::lexer::lexer lexer(code);
+        pljit::parser::parser parser(lexer);
+        auto parse_tree = parser.parse_function_definition();
+        EXPECT_TRUE(parse_tree);
+        ast = ASTCreator::CreateAST(*parse_tree);
+        EXPECT_TRUE(ast);
+        return bytecode_generator::generate(*ast);
+    }
+
+    std::optional<int64_t> execute(std::string_view source_string, const std::vector<int64_t>& parameters) {
+        return bytecode_function(generate(source_string)).execute(parameters.data());
+    }
+};
+
+TEST_F(Bytecode, BasicExecution) {
+    auto result = execute("PARAM width, height, depth;\n"
+                          "VAR volume, some;\n"
+                          "CONST density = 2400;\n"
+                          "BEGIN\n"
+                          "volume := width * height * depth;\n"
+                          "some := volume + width * 10 + height;\n"
+                          "RETURN\ndensity * volume\n"
+                          "END.",
+                          {10, 10, 10});
+    EXPECT_EQ(result, 2400000);
+}
+
+TEST_F(Bytecode, AssignmentsWriteSymbolRegisters) {
+    auto code = generate("PARAM a, b; VAR c; BEGIN c := a * b; a := c; RETURN a + 1 END.");
+    // c := a * b, a := c, t := a + 1, return t
+    ASSERT_EQ(code.instructions.size(), 4u);
+    EXPECT_EQ(code.instructions[0].operation, opcode::MULTIPLY);
+    EXPECT_EQ(code.instructions[0].destination, 2u);
+    EXPECT_EQ(code.instructions[1].operation, opcode::MOVE);
+    EXPECT_EQ(code.instructions[1].destination, 0u);
+    EXPECT_EQ(code.instructions[3].operation, opcode::RETURN);
+    // Three symbols, one literal and one temporary
+    EXPECT_EQ(code.register_template.size(), 5u);
+    EXPECT_EQ(code.register_template[3], 1);
+}
+
+TEST_F(Bytecode, MatchesInterpreter) {
+    const char* source = "PARAM a, b, c;\n"
+                         "VAR x, y;\n"
+                         "CONST k = 7, big = 123456789012;\n"
+                         "BEGIN\n"
+                         "x := (a - b) * -(c + k) / (b + 1);\n"
+                         "a := x - big / (a * a + 1);\n"
+                         "y := -a * (b - (c * (k - x)));\n"
+                         "x := +(x + y) * (y - x);\n"
+                         "RETURN (x + y) / k - +a\n"
+                         "END.";
+    for (int64_t a : {-50, -1, 0, 3, 1000}) {
+        for (int64_t b : {-7, 0, 12}) {
+            for (int64_t c : {-3, 0, 99}) {
+                std::vector<int64_t> parameters{a, b, c};
+                auto result = execute(source, parameters);
+                execution::ExecutionContext context(ast->getSymbolTable(), parameters);
+                EXPECT_EQ(result, ast->evaluate(context));
+            }
+        }
+    }
+}
+
+TEST_F(Bytecode, DivisionByZero) {
+    EXPECT_FALSE(execute("PARAM a; BEGIN RETURN 1000 / (a - 10) END.", {10}));
+    EXPECT_EQ(execute("PARAM a; BEGIN RETURN 1000 / (a - 10) END.", {11}), 1000);
+    EXPECT_EQ(execute("PARAM a, b; BEGIN RETURN a / b END.", {std::numeric_limits<int64_t>::min(), -1}), std::numeric_limits<int64_t>::min());
+}
@@ -0,0 +1,96 @@
+#include "pljit/semantic_analysis/ASTCreator.hpp"
+#include <pljit/codegen/closure/closure_compiler.hpp>
+#include <pljit/execution/ExecutionContext.hpp>
+#include <pljit/lexer/lexer.hpp>
+#include <pljit/parser/parser.hpp>
+#include <pljit/semantic_analysis/AST.hpp>
+#include <pljit/source_management/SourceCode.hpp>
+#include <limits>
+#include <gtest/gtest.h>
+
+using namespace pljit;
+using namespace pljit::semantic_analysis;
+using namespace pljit::source_management;
+
+class ClosureCompilation : public ::testing::Test {
+    protected:
+    SourceCode code;
+    std::unique_ptr<FunctionNode> ast;
+
+    std::optional<int64_t> execute(std::string_view source_string, const std::vector<int64_t>& parameters) {
+        code = SourceCode(source_string);
+        pljit::lexer::lexer lexer(code);
+        pljit::parser::parser parser(lexer);
+        auto parse_tree = parser.parse_function_definition();
+        EXPECT_TRUE(parse_tree);
+        ast = ASTCreator::CreateAST(*parse_tree);
+        EXPECT_TRUE(ast);
+        return codegen::closure::closure_compiler::compile(*ast)->execute(parameters.data());
+    }
+};
+
+TEST_F(ClosureCompilation, BasicExecution) {
+    auto result = execute("PARAM width, height, depth;\n"
+                          "VAR volume, some;\n"
+                          "CONST density = 2400;\n"
+                          "BEGIN\n"
+                          "volume := width * height * depth;\n"
+                          "some := volume + width * 10 + height;\n"
+                          "RETURN\ndensity * volume\n"
+                          "END.",
+                          {10, 10, 10});
+    EXPECT_EQ(result, 2400000);
+}
+
+TEST_F(ClosureCompilation, MatchesInterpreter) {
+    const char* source = "PARAM a, b, c;\n"
+                         "VAR x, y;\n"
+                         "CONST k = 7, big = 123456789012;\n"
+                         "BEGIN\n"
+                         "x := (a - b) * -(c + k) / (b + 1);\n"
+                         "a := x - big / (a * a + 1);\n"
+                         "y := -a * (b - (c * (k - x)));\n"
+                         "x := +(x + y) * (y - x) - -k + 3 * -5;\n"
+                         "RETURN (x + y) / k - +a\n"
+                         "END.";
+    for (int64_t a : {-50, -1, 0, 3, 1000}) {
+        for (int64_t b : {-7, 0, 12}) {
+            for (int64_t c : {-3, 0, 99}) {
+                std::vector<int64_t> parameters{a, b, c};
+                auto result = execute(source, parameters);
+                execution::ExecutionContext context(ast->getSymbolTable(), parameters);
+                EXPECT_EQ(result, ast->evaluate(context));
+            }
+        }
+    }
+}
+
+TEST_F(ClosureCompilation, LeafOnlyStatements) {
+    EXPECT_EQ(execute("BEGIN RETURN 42 END.", {}), 42);
+    EXPECT_EQ(execute("PARAM a; VAR b; BEGIN b := a; RETURN -b END.", {5}), -5);
+}
+
+TEST_F(ClosureCompilation, VariablesStartAtZeroInEveryCall) {
+    code = SourceCode("PARAM a; VAR x, y; BEGIN x := x + 1; y := y + a * x; RETURN x + y END.");
+    pljit::lexer::lexer lexer(code);
+    pljit::parser::parser parser(lexer);
+    auto parse_tree = parser.parse_function_definition();
+    ASSERT_TRUE(parse_tree);
+    ast = ASTCreator::CreateAST(*parse_tree);
+    ASSERT_TRUE(ast);
+    auto compiled = codegen::closure::closure_compiler::compile(*ast);
+    ASSERT_TRUE(compiled);
+    // Reuse one frame, like a caller that keeps a frame per thread
+    std::vector<int64_t> frame(compiled->get_frame_size());
+    for (int64_t a : {5, 5, -3, 5}) {
+        std::vector<int64_t> parameters{a};
+        execution::ExecutionContext context(ast->getSymbolTable(), parameters);
+        EXPECT_EQ(compiled->execute(parameters.data(), frame.data()), ast->evaluate(context));
+    }
+}
+
+TEST_F(ClosureCompilation, DivisionByZero) {
+    EXPECT_FALSE(execute("PARAM a; VAR b; BEGIN b := 1000 / (a - 10); RETURN 1 END.", {10}));
+    EXPECT_EQ(execute("PARAM a; BEGIN RETURN 1000 / (a - 10) END.", {11}), 1000);
+    EXPECT_EQ(execute("PARAM a, b; BEGIN RETURN a / b END.", {std::numeric_limits<int64_t>::min(), -1}), std::numeric_limits<int64_t>::min());
+}
@@ -0,0 +1,153 @@
+#include "pljit/semantic_analysis/ASTCreator.hpp"
+#include <pljit/codegen/x86_64/code_generator.hpp>
+#include <pljit/execution/ExecutionContext.hpp>
+#include <pljit/lexer/lexer.hpp>
+#include <pljit/optimization/passes/UnaryPlusRemoval.hpp>
+#include <pljit/parser/parser.hpp>
+#include <pljit/semantic_analysis/AST.hpp>
+#include <pljit/source_management/SourceCode.hpp>
+#include <limits>
+#include <gtest/gtest.h>
+
+using namespace pljit;
+using namespace pljit::semantic_analysis;
+using namespace pljit::source_management;
+
+class NativeCodeGeneration : public ::testing::Test {
+    protected:
+    SourceCode code;
+    std::unique_ptr<FunctionNode> ast;
+
+    std::unique_ptr<execution::compiled_function> compile(std::string_view source_string) {
+        code = SourceCode(source_string);
+        pljit::lexer::lexer lexer(code);
+        pljit::parser::parser parser(lexer);
+        auto parse_tree = parser.parse_function_definition();
+        EXPECT_TRUE(parse_tree);
+        ast = ASTCreator::CreateAST(*parse_tree);
+        EXPECT_TRUE(ast);
+        return codegen::x86_64::code_generator::compile(*ast);
+    }
+
+    /// Compares the native code against the AST interpreter
+    void expect_same_result(std::string_view source_string, const std::vector<int64_t>& parameters) {
+        auto native = compile(source_string);
+        ASSERT_TRUE(native);
+        execution::ExecutionContext context(ast->getSymbolTable(), parameters);
+        auto expected = ast->evaluate(context);
+        EXPECT_EQ(native->execute(parameters.data()), expected);
+    }
+};
+
+#if defined(__x86_64__) && defined(__unix__)
+
+TEST_F(NativeCodeGeneration, BasicExecution) {
+    auto native = compile("PARAM width, height, depth;\n"
+                          "VAR volume, some;\n"
+                          "CONST density = 2400;\n"
+                          "BEGIN\n"
+                          "volume := width * height * depth;\n"
+                          "some := volume + width * 10 + height;\n"
+                          "RETURN\ndensity * volume\n"
+                          "END.");
+    ASSERT_TRUE(native);
+    int64_t parameters[] = {10, 10, 10};
+    EXPECT_EQ(native->execute(parameters), 2400000);
+}
+
+TEST_F(NativeCodeGeneration, MatchesInterpreter) {
+    const char* source = "PARAM a, b, c;\n"
+                         "VAR x, y;\n"
+                         "CONST k = 7, big = 123456789012;\n"
+                         "BEGIN\n"
+                         "x := (a - b) * -(c + k) / (b + 1);\n"
+                         "a := x - big / (a * a + 1);\n"
+                         "y := -a * (b - (c * (k - x)));\n"
+                         "RETURN (x + y) / k - +a\n"
+                         "END.";
+    for (int64_t a : {-50, -1, 0, 3, 1000}) {
+        for (int64_t b : {-7, 0, 12}) {
+            for (int64_t c : {-3, 0, 99}) {
+                expect_same_result(source, {a, b, c});
+            }
+        }
+    }
+}
+
+TEST_F(NativeCodeGeneration, VariablesStartAtZeroInEveryCall) {
+    auto native = compile("PARAM a; VAR x, y; BEGIN x := x + 1; y := y + a * x; RETURN x + y END.");
+    ASSERT_TRUE(native);
+    for (int64_t a : {5, 5, -3, 5}) {
+        std::vector<int64_t> parameters{a};
+        execution::ExecutionContext context(ast->getSymbolTable(), parameters);
+        EXPECT_EQ(native->execute(parameters.data()), ast->evaluate(context));
+    }
+}
+
+TEST_F(NativeCodeGeneration, DivisionByZero) {
+    auto native = compile("PARAM a; BEGIN RETURN 1000 / (a - 10) END.");
+    ASSERT_TRUE(native);
+    int64_t zero_divisor[] = {10};
+    EXPECT_FALSE(native->execute(zero_divisor));
+    int64_t divisor[] = {11};
+    EXPECT_EQ(native->execute(divisor), 1000);
+}
+
+TEST_F(NativeCodeGeneration, DivisionOverflowWrapsAround) {
+    auto native = compile("PARAM a, b; BEGIN RETURN a / b END.");
+    ASSERT_TRUE(native);
+    int64_t parameters[] = {std::numeric_limits<int64_t>::min(), -1};
+    EXPECT_EQ(native->execute(parameters), std::numeric_limits<int64_t>::min());
+}
+
+TEST_F(NativeCodeGeneration, MultiplicationByConstants) {
+    const std::vector<int64_t> values = {0, 1, -1, 7, -123456789, std::numeric_limits<int64_t>::max(), std::numeric_limits<int64_t>::min()};
+    for (const char* source : {"PARAM a; BEGIN RETURN a * 8 END.",
+                               "PARAM a; BEGIN RETURN -16 * a END.",
+                               "PARAM a; CONST k = 4611686018427387904; BEGIN RETURN a * k END.",
+                               "PARAM a; CONST k = 2; BEGIN RETURN k * (a + 1) END.",
+                               "PARAM a; BEGIN RETURN a * 0 END.",
+                               "PARAM a; BEGIN RETURN a * -1 END."}) {
+        for (int64_t a : values) {
+            expect_same_result(source, {a});
+        }
+    }
+    auto native = compile("PARAM a; BEGIN RETURN (1 / a) * 0 END.");
+    ASSERT_TRUE(native);
+    int64_t zero[] = {0};
+    EXPECT_FALSE(native->execute(zero));
+}
+
+TEST_F(NativeCodeGeneration, DivisionByConstants) {
+    const std::vector<int64_t> divisors = {1, -1, 2, -2, 3, -3, 5, 6, 7, -7, 10, 16, -64, 641, 1000, -1000000007,
+                                           std::numeric_limits<int64_t>::max(), std::numeric_limits<int64_t>::min(),
+                                           std::numeric_limits<int64_t>::min() + 1, int64_t{1} << 62};
+    const std::vector<int64_t> dividends = {0, 1, -1, 2, -2, 6, -6, 7, -7, 999, -1001, 123456789012345,
+                                            std::numeric_limits<int64_t>::max(), std::numeric_limits<int64_t>::max() - 1,
+                                            std::numeric_limits<int64_t>::min(), std::numeric_limits<int64_t>::min() + 1};
+    for (int64_t divisor : divisors) {
+        compile("PARAM a; BEGIN RETURN a / 1 END.");
+        // Literals are non-negative, patch the divisor into the AST
+        optimization::passes::UnaryPlusRemoval().optimize_ast(ast);
+        auto& division = static_cast<BinaryOperatorASTNode&>(static_cast<ReturnStatementNode&>(*ast->get_statement(0)).get_expression());
+        division.releaseRight() = std::make_unique<LiteralNode>(divisor);
+        auto native = codegen::x86_64::code_generator::compile(*ast);
+        ASSERT_TRUE(native);
+        for (int64_t dividend : dividends) {
+            const int64_t expected = divisor == -1 ? static_cast<int64_t>(0 - static_cast<uint64_t>(dividend)) : dividend / divisor;
+            EXPECT_EQ(native->execute(&dividend), expected) << dividend << " / " << divisor;
+        }
+    }
+    auto native = compile("PARAM a; BEGIN RETURN a / 0 END.");
+    ASSERT_TRUE(native);
+    int64_t dividend[] = {42};
+    EXPECT_FALSE(native->execute(dividend));
+}
+
+TEST_F(NativeCodeGeneration, StatementsAfterReturn) {
+    auto native = compile("VAR a; BEGIN a := 1; RETURN a; a := 0 / 0 END.");
+    ASSERT_TRUE(native);
+    EXPECT_EQ(native->execute(nullptr), 1);
+}
+
+#endif
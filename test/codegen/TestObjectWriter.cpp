@@ -0,0 +1,93 @@
+#include "pljit/semantic_analysis/ASTCreator.hpp"
+#include <pljit/codegen/elf/object_writer.hpp>
+#include <pljit/codegen/executable_memory.hpp>
+#include <pljit/codegen/x86_64/code_generator.hpp>
+#include <pljit/lexer/lexer.hpp>
+#include <pljit/parser/parser.hpp>
+#include <pljit/semantic_analysis/AST.hpp>
+#include <pljit/source_management/SourceCode.hpp>
+#include <cstring>
+#include <elf.h>
+#include <gtest/gtest.h>
+
+using namespace pljit;
+using namespace pljit::semantic_analysis;
+using namespace pljit::source_management;
+
+class ObjectWriter : public ::testing::Test {
+    protected:
+    SourceCode code;
+
+    std::vector<uint8_t> generate(std::string_view source_string) {
+        code = SourceCode(source_string);
+        pljit::lexer::lexer lexer(code);
+        pljit::parser::parser parser(lexer);
+        auto parse_tree = parser.parse_function_definition();
+        EXPECT_TRUE(parse_tree);
+        auto ast = ASTCreator::CreateAST(*parse_tree);
+        EXPECT_TRUE(ast);
+        return codegen::x86_64::code_generator::generate(*ast);
+    }
+
+    template <class T>
+    static T read(const std::vector<uint8_t>& object, uint64_t offset) {
+        T value;
+        std::memcpy(&value, object.data() + offset, sizeof(T));
+        return value;
+    }
+};
+
+TEST_F(ObjectWriter, ExportsFunctionSymbols) {
+    codegen::elf::object_writer writer;
+    writer.add_function("scale", generate("PARAM a, b; BEGIN RETURN (a * 3) / b END."));
+    writer.add_function("increment", generate("PARAM a; BEGIN RETURN a + 1 END."));
+    auto object = writer.finalize();
+
+    auto header = read<Elf64_Ehdr>(object, 0);
+    ASSERT_EQ(std::memcmp(header.e_ident, ELFMAG, SELFMAG), 0);
+    EXPECT_EQ(header.e_type, ET_REL);
+    EXPECT_EQ(header.e_machine, EM_X86_64);
+    ASSERT_LE(header.e_shoff + header.e_shnum * sizeof(Elf64_Shdr), object.size());
+
+    // Locate .text and the symbols through the section headers, like a linker would
+    Elf64_Shdr text{}, symtab{}, strtab{};
+    for (unsigned i = 0; i < header.e_shnum; ++i) {
+        auto section = read<Elf64_Shdr>(object, header.e_shoff + i * sizeof(Elf64_Shdr));
+        if (section.sh_type == SHT_PROGBITS && (section.sh_flags & SHF_EXECINSTR)) text = section;
+        if (section.sh_type == SHT_SYMTAB) {
+            symtab = section;
+            strtab = read<Elf64_Shdr>(object, header.e_shoff + section.sh_link * sizeof(Elf64_Shdr));
+        }
+    }
+    ASSERT_EQ(symtab.sh_size / sizeof(Elf64_Sym), 3u);
+
+    std::vector<uint8_t> text_section(object.begin() + text.sh_offset, object.begin() + text.sh_offset + text.sh_size);
+    uint64_t scale_offset = 0, increment_offset = 0;
+    for (unsigned i = 1; i < 3; ++i) {
+        auto symbol = read<Elf64_Sym>(object, symtab.sh_offset + i * sizeof(Elf64_Sym));
+        EXPECT_EQ(ELF64_ST_BIND(symbol.st_info), STB_GLOBAL);
+        EXPECT_EQ(ELF64_ST_TYPE(symbol.st_info), STT_FUNC);
+        EXPECT_EQ(symbol.st_value % 16, 0u);
+        std::string name(reinterpret_cast<const char*>(object.data() + strtab.sh_offset + symbol.st_name));
+        (name == "scale" ? scale_offset : increment_offset) = symbol.st_value;
+    }
+    EXPECT_GT(increment_offset, scale_offset);
+
+#if defined(__x86_64__) && defined(__unix__)
+    // The code is position independent, so it runs from wherever .text is placed
+    auto memory = codegen::executable_memory::allocate(text_section);
+    ASSERT_TRUE(memory);
+    using entry_point = bool (*)(const int64_t*, int64_t*);
+    auto scale = reinterpret_cast<entry_point>(reinterpret_cast<uintptr_t>(memory->get()) + scale_offset);
+    auto increment = reinterpret_cast<entry_point>(reinterpret_cast<uintptr_t>(memory->get()) + increment_offset);
+    int64_t result = 0;
+    const int64_t scale_parameters[] = {8, 4};
+    ASSERT_TRUE(scale(scale_parameters, &result));
+    EXPECT_EQ(result, 6);
+    const int64_t division_by_zero[] = {8, 0};
+    EXPECT_FALSE(scale(division_by_zero, &result));
+    const int64_t increment_parameters[] = {41};
+    ASSERT_TRUE(increment(increment_parameters, &result));
+    EXPECT_EQ(result, 42);
+#endif
+}
@@ -0,0 +1,159 @@
+#include "pljit/semantic_analysis/ASTCreator.hpp"
+#include <pljit/execution/ExecutionContext.hpp>
+#include <pljit/ir/ast_lowering.hpp>
+#include <pljit/ir/ssa_builder.hpp>
+#include <pljit/ir/ssa_passes.hpp>
+#include <pljit/lexer/lexer.hpp>
+#include <pljit/optimization/passes/UnaryPlusRemoval.hpp>
+#include <pljit/optimization/passes/ssa_optimization.hpp>
+#include <pljit/parser/parser.hpp>
+#include <pljit/semantic_analysis/AST.hpp>
+#include <pljit/semantic_analysis/dot_print_visitor.hpp>
+#include <pljit/source_management/SourceCode.hpp>
+#include <algorithm>
+#include <limits>
+#include <sstream>
+#include <gtest/gtest.h>
+
+using namespace pljit;
+using namespace pljit::ir;
+using namespace pljit::semantic_analysis;
+using namespace pljit::source_management;
+
+class SSA : public ::testing::Test {
+    protected:
+    SourceCode code;
+
+    std::unique_ptr<FunctionNode> create_ast(std::string_view source_string) {
+        code = SourceCode(source_string);
+        pljit::lexer::lexer lexer(code);
+        pljit::parser::parser parser(lexer);
+        auto parse_tree = parser.parse_function_definition();
+        EXPECT_TRUE(parse_tree.get());
+        return ASTCreator::CreateAST(*parse_tree);
+    }
+};
+
+namespace {
+std::string to_dot(ASTNode& ast) {
+    std::stringstream output_stream;
+    pljit::semantic_analysis::dot_print_visitor dot_printer(output_stream);
+    ast.accept(dot_printer);
+    return output_stream.str();
+}
+
+std::size_t count(const ssa_function& function, opcode operation) {
+    return static_cast<std::size_t>(std::count_if(function.values.begin(), function.values.end(), [operation](const auto& value) { return value.operation == operation; }));
+}
+} // namespace
+
+TEST_F(SSA, EveryAssignmentDefinesAValue) {
+    auto ast = create_ast("PARAM a, b; VAR x; CONST k = 2; BEGIN x := a; x := +x * k; RETURN x + b; x := 0 END.");
+    auto function = ssa_builder::build(*ast);
+    // The copy of a and unary plus disappear, the statement after the return is not translated
+    ASSERT_EQ(function.values.size(), 5u);
+    EXPECT_EQ(function.number_of_parameters, 2u);
+    EXPECT_EQ(function.values[0].operation, opcode::PARAMETER);
+    EXPECT_EQ(function.values[1].operation, opcode::PARAMETER);
+    EXPECT_EQ(function.values[2].operation, opcode::CONSTANT);
+    const auto& product = function.values[3];
+    EXPECT_EQ(product.operation, opcode::MULTIPLY);
+    EXPECT_EQ(product.lhs, 0u);
+    EXPECT_EQ(product.rhs, 2u);
+    EXPECT_EQ(function.result, 4u);
+    EXPECT_EQ(function.values[4].lhs, 3u);
+}
+
+TEST_F(SSA, VariablesReadBeforeTheirAssignmentAreZero) {
+    const std::pair<const char*, std::vector<int64_t>> programs[] = {
+        {"PARAM a; VAR x; BEGIN x := x + 1; RETURN x END.", {100}},
+        {"VAR x; BEGIN x := x + 1; RETURN x END.", {}},
+    };
+    for (const auto& [source, parameters] : programs) {
+        auto ast = create_ast(source);
+        auto function = ssa_builder::build(*ast);
+        optimize(function);
+        auto lowered = ast_lowering::lower(function, ast->getSymbolTable());
+        execution::ExecutionContext context(lowered->getSymbolTable(), parameters);
+        EXPECT_EQ(lowered->evaluate(context), 1) << source;
+    }
+}
+
+TEST_F(SSA, PropagateConstants) {
+    constexpr auto min = std::numeric_limits<int64_t>::min();
+    ssa_function function;
+    function.values = {{opcode::CONSTANT, 0, 0, min},
+                       {opcode::CONSTANT, 0, 0, -1},
+                       {opcode::DIVIDE, 0, 1},
+                       {opcode::NEGATE, 0},
+                       {opcode::CONSTANT, 0, 0, 0},
+                       {opcode::DIVIDE, 1, 4},
+                       {opcode::MULTIPLY, 2, 3},
+                       {opcode::SUBTRACT, 6, 1}};
+    function.result = 7;
+    propagate_constants(function);
+    // Arithmetic wraps around
+    EXPECT_EQ(function.values[2].operation, opcode::CONSTANT);
+    EXPECT_EQ(function.values[2].immediate, min);
+    EXPECT_EQ(function.values[3].immediate, min);
+    EXPECT_EQ(function.values[6].immediate, 0);
+    EXPECT_EQ(function.values[7].immediate, 1);
+    // Division by zero fails at run time
+    EXPECT_EQ(function.values[5].operation, opcode::DIVIDE);
+    EXPECT_TRUE(function.may_fail(5));
+}
+
+TEST_F(SSA, EliminateCommonSubexpressions) {
+    auto ast = create_ast("PARAM a, b; VAR x, y; BEGIN x := a * b; y := b * a; RETURN (x - y) + (a * b - x) END.");
+    auto function = ssa_builder::build(*ast);
+    EXPECT_EQ(count(function, opcode::MULTIPLY), 3u);
+    eliminate_common_subexpressions(function);
+    eliminate_dead_values(function);
+    EXPECT_EQ(count(function, opcode::MULTIPLY), 1u);
+    EXPECT_EQ(count(function, opcode::SUBTRACT), 1u);
+}
+
+TEST_F(SSA, EliminateDeadValuesKeepsFailingDivisions) {
+    auto ast = create_ast("PARAM a, b; VAR x, y, z; BEGIN x := a * b; y := b / a; z := a / 2; RETURN a - 1 END.");
+    auto function = ssa_builder::build(*ast);
+    optimize(function);
+    // b / a may fail, a * b and a / 2 cannot and are unused
+    EXPECT_EQ(count(function, opcode::MULTIPLY), 0u);
+    EXPECT_EQ(count(function, opcode::DIVIDE), 1u);
+    EXPECT_EQ(count(function, opcode::SUBTRACT), 1u);
+    for (value_id value = 0; value < function.values.size(); ++value) {
+        const auto& definition = function.values[value];
+        if (definition.is_binary()) {
+            EXPECT_LT(definition.lhs, value);
+            EXPECT_LT(definition.rhs, value);
+        }
+    }
+
+    auto lowered = ast_lowering::lower(function, ast->getSymbolTable());
+    execution::ExecutionContext failing(lowered->getSymbolTable(), 0, 1);
+    EXPECT_FALSE(lowered->evaluate(failing));
+    execution::ExecutionContext context(lowered->getSymbolTable(), 3, 1);
+    EXPECT_EQ(lowered->evaluate(context), 2);
+}
+
+TEST_F(SSA, LoweringInlinesValuesUsedOnce) {
+    auto ref_ast = create_ast("PARAM a, b; VAR t; BEGIN t := a * b; RETURN t + (t - 6) END.");
+    pljit::optimization::passes::UnaryPlusRemoval().optimize_ast(ref_ast);
+    auto ast = create_ast("PARAM a, b; VAR x, y; CONST k = 3; BEGIN x := a * b; y := x; x := k * 2; RETURN y + (b * a - x) END.");
+    pljit::optimization::passes::ssa_optimization().optimize_ast(ast);
+    EXPECT_EQ(to_dot(*ast), to_dot(*ref_ast));
+
+    const auto& symbols = ast->getSymbolTable();
+    EXPECT_EQ(symbols.get_number_of_parameters(), 2u);
+    EXPECT_EQ(symbols.get_number_of_variables(), 1u);
+    EXPECT_EQ(symbols.get_number_of_constants(), 0u);
+    EXPECT_EQ(symbols.get(1).get_name(), "b");
+
+    execution::ExecutionContext context(symbols, 4, 5);
+    EXPECT_EQ(ast->evaluate(context), 20 + 14);
+
+    // Lowering is stable, so the O2 fixpoint loop terminates
+    const auto reference = to_dot(*ast);
+    pljit::optimization::passes::ssa_optimization().optimize_ast(ast);
+    EXPECT_EQ(to_dot(*ast), reference);
+}
@@ -0,0 +1,276 @@
+#include "pljit/semantic_analysis/ASTCreator.hpp"
+#include <pljit/Pljit.hpp>
+#include <pljit/execution/ExecutionContext.hpp>
+#include <pljit/lexer/lexer.hpp>
+#include <pljit/parser/parser.hpp>
+#include <pljit/persistence/ast_serializer.hpp>
+#include <pljit/persistence/code_cache.hpp>
+#include <pljit/persistence/snapshot_image.hpp>
+#include <pljit/semantic_analysis/AST.hpp>
+#include <pljit/semantic_analysis/dot_print_visitor.hpp>
+#include <pljit/source_management/SourceCode.hpp>
+#include <fstream>
+#include <sstream>
+#include <gtest/gtest.h>
+
+using namespace pljit;
+using namespace pljit::semantic_analysis;
+using namespace pljit::source_management;
+using namespace pljit::persistence;
+
+namespace {
+const char* example_source = "PARAM width, height; VAR volume; CONST density = 2400;\n"
+                             "BEGIN volume := width * -height; RETURN density * volume / (width - 1) END.";
+
+std::string to_dot(ASTNode& ast) {
+    std::stringstream output_stream;
+    dot_print_visitor dot_printer(output_stream);
+    ast.accept(dot_printer);
+    return output_stream.str();
+}
+} // namespace
+
+class Persistence : public ::testing::Test {
+    protected:
+    SourceCode code;
+    std::filesystem::path directory;
+
+    std::unique_ptr<FunctionNode> create_ast(std::string_view source_string) {
+        code = SourceCode(source_string);
+        pljit::lexer::lexer lexer(code);
+        pljit::parser::parser parser(lexer);
+        auto parse_tree = parser.parse_function_definition();
+        EXPECT_TRUE(parse_tree);
+        return ASTCreator::CreateAST(*parse_tree);
+    }
+
+    void SetUp() override {
+        directory = std::filesystem::temp_directory_path() / ("pljit_test_" + std::to_string(::getpid()) + "_" + ::testing::UnitTest::GetInstance()->current_test_info()->name());
+        std::filesystem::remove_all(directory);
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(directory);
+    }
+};
+
+TEST_F(Persistence, SerializationRoundTrip) {
+    auto ast = create_ast(example_source);
+    auto encoded = ast_serializer::serialize(*ast);
+    auto decoded = ast_serializer::deserialize(encoded.data(), encoded.size());
+    ASSERT_TRUE(decoded);
+    EXPECT_EQ(to_dot(*decoded), to_dot(*ast));
+    ASSERT_EQ(decoded->getSymbolTable().size(), 4u);
+    EXPECT_EQ(decoded->getSymbolTable().get_number_of_parameters(), 2u);
+
+    execution::ExecutionContext expected(ast->getSymbolTable(), 3, 4);
+    execution::ExecutionContext actual(decoded->getSymbolTable(), 3, 4);
+    EXPECT_EQ(decoded->evaluate(actual), ast->evaluate(expected));
+}
+
+TEST_F(Persistence, MalformedDataIsRejected) {
+    auto ast = create_ast(example_source);
+    auto encoded = ast_serializer::serialize(*ast);
+    for (std::size_t size = 0; size < encoded.size(); ++size) {
+        EXPECT_FALSE(ast_serializer::deserialize(encoded.data(), size));
+    }
+    encoded.push_back(0);
+    EXPECT_FALSE(ast_serializer::deserialize(encoded.data(), encoded.size()));
+    encoded.pop_back();
+    // Symbol of unknown type
+    encoded[4] = 17;
+    EXPECT_FALSE(ast_serializer::deserialize(encoded.data(), encoded.size()));
+}
+
+TEST_F(Persistence, CodeCacheStoresAndLoads) {
+    code_cache cache(directory, 1);
+    EXPECT_FALSE(cache.load("key"));
+
+    auto ast = create_ast(example_source);
+    cache.store("key", *ast);
+    auto loaded = cache.load("key");
+    ASSERT_TRUE(loaded);
+    EXPECT_EQ(to_dot(*loaded), to_dot(*ast));
+    EXPECT_FALSE(cache.load("other key"));
+}
+
+TEST_F(Persistence, EntriesOfOtherCompilerVersionsAreIgnored) {
+    auto ast = create_ast(example_source);
+    code_cache(directory, 1).store("key", *ast);
+    EXPECT_TRUE(code_cache(directory, 1).load("key"));
+    EXPECT_FALSE(code_cache(directory, 2).load("key"));
+
+    // Same file name, but the header names another compiler version
+    std::filesystem::path entry;
+    for (const auto& file : std::filesystem::directory_iterator(directory)) {
+        entry = file.path();
+    }
+    ASSERT_FALSE(entry.empty());
+    std::vector<char> content;
+    {
+        std::ifstream file(entry, std::ios::binary);
+        content.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+    content[8] ^= 1;
+    {
+        std::ofstream file(entry, std::ios::binary | std::ios::trunc);
+        file.write(content.data(), static_cast<std::streamsize>(content.size()));
+    }
+    EXPECT_FALSE(code_cache(directory, 1).load("key"));
+}
+
+TEST_F(Persistence, CorruptEntriesAreIgnored) {
+    code_cache cache(directory, 1);
+    auto ast = create_ast(example_source);
+    cache.store("key", *ast);
+
+    std::filesystem::path entry;
+    for (const auto& file : std::filesystem::directory_iterator(directory)) {
+        entry = file.path();
+    }
+    ASSERT_FALSE(entry.empty());
+    std::vector<char> content;
+    {
+        std::ifstream file(entry, std::ios::binary);
+        content.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+    auto write = [&](const std::vector<char>& data) {
+        std::ofstream file(entry, std::ios::binary | std::ios::trunc);
+        file.write(data.data(), static_cast<std::streamsize>(data.size()));
+    };
+
+    // Flipped payload byte
+    auto corrupted = content;
+    corrupted.back() ^= 1;
+    write(corrupted);
+    EXPECT_FALSE(cache.load("key"));
+
+    // Entry written by another format version
+    auto stale = content;
+    stale[4] ^= 1;
+    write(stale);
+    EXPECT_FALSE(cache.load("key"));
+
+    // Truncated entry
+    write(std::vector<char>(content.begin(), content.begin() + 10));
+    EXPECT_FALSE(cache.load("key"));
+
+    // Storing again repairs the entry
+    cache.store("key", *ast);
+    EXPECT_TRUE(cache.load("key"));
+}
+
+TEST_F(Persistence, PljitWarmStart) {
+    {
+        pljit::Pljit compiler;
+        compiler.set_disk_cache(directory);
+        auto handle = compiler.register_function(example_source);
+        EXPECT_EQ(*handle(3, 4).get_result(), 2400 * 3 * -4 / 2);
+        EXPECT_FALSE(compiler.get(handle.get_id()).get_pass_statistics().empty());
+    }
+    EXPECT_FALSE(std::filesystem::is_empty(directory));
+    {
+        pljit::Pljit compiler;
+        compiler.set_disk_cache(directory);
+        auto handle = compiler.register_function(example_source);
+        EXPECT_EQ(*handle(3, 4).get_result(), 2400 * 3 * -4 / 2);
+        // Loaded instead of optimized again
+        EXPECT_TRUE(compiler.get(handle.get_id()).get_pass_statistics().empty());
+    }
+}
+
+TEST_F(Persistence, SnapshotImageRoundTrip) {
+    std::filesystem::create_directories(directory);
+    const auto path = directory / "functions.image";
+    std::vector<std::string> sources;
+    {
+        pljit::Pljit compiler;
+        for (int64_t i = 0; i < 100; ++i) {
+            sources.push_back("PARAM a, b; VAR c; CONST d = " + std::to_string(i) + "; BEGIN c := a * d; RETURN c / b END.");
+            compiler.register_function(sources.back());
+        }
+        compiler.register_function("PARAM a; BEGIN RETURN b END.");
+        ASSERT_TRUE(compiler.save_image(path));
+    }
+
+    auto image = snapshot_image::load(path);
+    ASSERT_TRUE(image);
+    ASSERT_EQ(image->size(), 101u);
+    for (int64_t i = 0; i < 100; ++i) {
+        auto function = image->get(i);
+        EXPECT_EQ(function.get_number_of_parameters(), 2u);
+        auto result = function(7, 2);
+        ASSERT_TRUE(result);
+        EXPECT_EQ(*result.get_result(), 7 * i / 2);
+        EXPECT_FALSE(function(7, 0));
+
+        std::vector<int64_t> frame(function.get_frame_size());
+        const int64_t parameters[] = {5, 1};
+        EXPECT_EQ(function.call(parameters, frame.data()), 5 * i);
+    }
+    EXPECT_FALSE(image->get(100)(1));
+
+    // Optimization removed the constant d
+    auto function = image->get(42);
+    ASSERT_EQ(function.get_number_of_symbols(), 3u);
+    const char* names[] = {"a", "b", "c"};
+    for (std::size_t i = 0; i < 3; ++i) {
+        const auto symbol = function.get_symbol(i);
+        EXPECT_EQ(symbol.name, names[i]);
+        EXPECT_EQ(symbol.type, i < 2 ? symbol::PARAMETER : symbol::VARIABLE);
+        EXPECT_EQ(symbol.register_index, i);
+    }
+
+    // Moving keeps the mapping alive
+    auto moved = std::move(*image);
+    EXPECT_EQ(*moved.get(3)(2, 1).get_result(), 6);
+}
+
+TEST_F(Persistence, InvalidSnapshotImagesAreRejected) {
+    std::filesystem::create_directories(directory);
+    const auto path = directory / "functions.image";
+    EXPECT_FALSE(snapshot_image::load(path));
+
+    image_function code;
+    code.code.instructions = {{codegen::bytecode::opcode::ADD, 2, 0, 1}, {codegen::bytecode::opcode::RETURN, 0, 2, 0}};
+    code.code.register_template = {0, 0, 7};
+    code.code.number_of_parameters = 2;
+    code.symbols = {{"x", symbol::PARAMETER}, {"y", symbol::PARAMETER}, {"", symbol::CONSTANT}};
+    auto image = snapshot_image::build({code});
+    ASSERT_TRUE(snapshot_image::write(path, image));
+    auto loaded = snapshot_image::load(path);
+    ASSERT_TRUE(loaded);
+    EXPECT_EQ(*loaded->get(0)(20, 22).get_result(), 42);
+    EXPECT_EQ(loaded->get(0).get_symbol(1).name, "y");
+    EXPECT_EQ(loaded->get(0).get_symbol(2).name, "");
+    EXPECT_EQ(loaded->get(0).get_symbol(2).value, 7);
+
+    // An operand outside of the register file
+    auto out_of_bounds = code;
+    out_of_bounds.code.instructions[0].lhs = 3;
+    ASSERT_TRUE(snapshot_image::write(path, snapshot_image::build({out_of_bounds})));
+    EXPECT_FALSE(snapshot_image::load(path));
+
+    // Running off the end of the program
+    auto no_return = code;
+    no_return.code.instructions.pop_back();
+    ASSERT_TRUE(snapshot_image::write(path, snapshot_image::build({no_return})));
+    EXPECT_FALSE(snapshot_image::load(path));
+
+    // More symbols than registers
+    auto too_many_symbols = code;
+    too_many_symbols.symbols.push_back({"z", symbol::VARIABLE});
+    ASSERT_TRUE(snapshot_image::write(path, snapshot_image::build({too_many_symbols})));
+    EXPECT_FALSE(snapshot_image::load(path));
+
+    // Symbol of unknown type
+    auto unknown_type = code;
+    unknown_type.symbols[0].type = static_cast<symbol::symbol_type>(17);
+    ASSERT_TRUE(snapshot_image::write(path, snapshot_image::build({unknown_type})));
+    EXPECT_FALSE(snapshot_image::load(path));
+
+    // Truncated image
+    image.resize(image.size() - 8);
+    ASSERT_TRUE(snapshot_image::write(path, image));
+    EXPECT_FALSE(snapshot_image::load(path));
+}
@@ -0,0 +1,127 @@
+#include <gtest/gtest.h>
+
+#include "pljit/Pljit.hpp"
+#include "pljit/workload/program_generator.hpp"
+
+using namespace pljit;
+using namespace pljit::workload;
+
+namespace {
+
+constexpr execution_engine engines[] = {execution_engine::INTERPRETER, execution_engine::NATIVE, execution_engine::BYTECODE,
+                                        execution_engine::CLOSURE, execution_engine::COPY_AND_PATCH};
+
+void expect_results(const generated_program& program, optimization::optimization_level optimization = optimization::optimization_level::O1) {
+    for (auto engine : engines) {
+        Function function(program.source, function_options(engine, 0, optimization));
+        ASSERT_TRUE(function.wait()) << program.source << function.get_diagnostics();
+        for (std::size_t i = 0; i < program.arguments.size(); ++i) {
+            EXPECT_EQ(function.call(program.arguments[i].data()), program.results[i]) << program.source;
+        }
+    }
+}
+
+} // namespace
+
+TEST(ProgramGenerator, ProgramsMatchTheirResults) {
+    program_generator generator;
+    for (unsigned i = 0; i < 50; ++i) {
+        expect_results(generator.generate());
+    }
+}
+
+TEST(ProgramGenerator, OptimizedProgramsMatchTheirResults) {
+    // Few symbols and small literals make repeated subexpressions likely
+    generator_options options;
+    options.parameters = 2;
+    options.variables = 2;
+    options.constants = 1;
+    options.max_literal = 3;
+    options.statements = 16;
+    program_generator generator(options);
+    for (unsigned i = 0; i < 50; ++i) {
+        expect_results(generator.generate(), optimization::optimization_level::O2);
+    }
+}
+
+TEST(ProgramGenerator, Deterministic) {
+    program_generator first({}, 7), second({}, 7), other({}, 8);
+    const auto program = first.generate();
+    const auto same = second.generate();
+    EXPECT_EQ(program.source, same.source);
+    EXPECT_EQ(program.arguments, same.arguments);
+    EXPECT_EQ(program.results, same.results);
+    EXPECT_NE(program.source, other.generate().source);
+}
+
+TEST(ProgramGenerator, Knobs) {
+    generator_options options;
+    options.parameters = 3;
+    options.variables = 0;
+    options.constants = 0;
+    options.statements = 5;
+    options.argument_sets = 4;
+    options.division_density = 0;
+    options.plus_weight = 1;
+    options.minus_weight = 0;
+    options.multiply_weight = 0;
+    options.negation_density = 0;
+    const auto program = program_generator(options).generate();
+    EXPECT_EQ(program.source.find("VAR"), std::string::npos);
+    EXPECT_EQ(program.source.find("CONST"), std::string::npos);
+    EXPECT_EQ(program.source.find_first_of("-*/"), std::string::npos);
+    EXPECT_EQ(program.arguments.size(), 4u);
+    EXPECT_EQ(program.arguments[0].size(), 3u);
+    expect_results(program);
+
+    // Only literals are left to read
+    options.parameters = 0;
+    options.statements = 0;
+    expect_results(program_generator(options).generate());
+}
+
+TEST(ProgramGenerator, LargePrograms) {
+    generator_options options;
+    options.parameters = 16;
+    options.variables = 200;
+    options.constants = 50;
+    options.statements = 2000;
+    options.max_expression_depth = 6;
+    options.multiply_weight = 4;
+    expect_results(program_generator(options).generate());
+}
+
+TEST(ProgramGenerator, DivisionByZero) {
+    generator_options options;
+    options.parameters = 2;
+    options.max_argument = 2;
+    options.max_literal = 2;
+    options.division_density = 0.5;
+    options.argument_sets = 16;
+    options.allow_division_by_zero = true;
+    program_generator generator(options);
+    bool failed = false;
+    for (unsigned i = 0; i < 20; ++i) {
+        const auto program = generator.generate();
+        failed |= std::find(program.results.begin(), program.results.end(), std::nullopt) != program.results.end();
+        expect_results(program);
+    }
+    EXPECT_TRUE(failed);
+}
+
+TEST(ProgramGenerator, BulkRegistration) {
+    program_generator generator;
+    std::vector<generated_program> programs;
+    std::vector<std::string> sources;
+    for (unsigned i = 0; i < 500; ++i) {
+        programs.push_back(generator.generate());
+        sources.push_back(programs.back().source);
+    }
+    Pljit compiler;
+    const auto results = compiler.register_functions(sources);
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        ASSERT_TRUE(results[i].success) << results[i].diagnostics;
+        auto& function = compiler.get(results[i].handle.get_id());
+        EXPECT_EQ(function.call(programs[i].arguments[0].data()), programs[i].results[0]);
+    }
+}